@@ -0,0 +1,291 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: BVH.h
+// ========
+// Class definition for bounding volume hierarchy.
+//
+// Author: Paulo Pagliosa
+// Last revision: 17/10/2026
+
+#ifndef __BVH_h
+#define __BVH_h
+
+#include "geometry/TriangleMesh.h"
+#include <vector>
+
+namespace cg
+{ // begin namespace cg
+
+
+//////////////////////////////////////////////////////////
+//
+// BVHBase: bounding volume hierarchy base class
+// =======
+//
+// A BVH over a set of primitives given by their bounds, built top-down
+// with the binned surface area heuristic (SAH). Nodes are stored
+// depth-first in a flat array: the left child of an interior node
+// immediately follows it.
+class BVHBase: public SharedObject
+{
+public:
+  struct Node
+  {
+    Bounds3f bounds;
+    int first; // first primitive (leaf) or right child (interior)
+    int count; // number of primitives, 0 for an interior node
+
+    bool isLeaf() const
+    {
+      return count > 0;
+    }
+
+  }; // Node
+
+  static constexpr int maxDepth = 64;
+  static constexpr int maxLeafSize = 64;
+
+  /// Returns the bounds of this BVH.
+  Bounds3f bounds() const
+  {
+    return _nodes.empty() ? Bounds3f{} : _nodes[0].bounds;
+  }
+
+  /// Returns the nodes of this BVH.
+  const std::vector<Node>& nodes() const
+  {
+    return _nodes;
+  }
+
+  /// Returns the primitive indices referenced by the leaves of this BVH.
+  const std::vector<int>& primitiveIds() const
+  {
+    return _primitiveIds;
+  }
+
+  /// \brief Visits the primitives whose leaves are intersected by \c ray,
+  /// nearest leaves first. The visitor is called as f(id, tMax) and may
+  /// shrink tMax to prune farther nodes; it returns true to stop.
+  template <typename Visitor>
+  bool traverse(const Ray& ray, Visitor f) const;
+
+  /// \brief Visits the primitives whose leaves pass \c test, called as
+  /// test(bounds) for every visited node. The visitor is called as f(id).
+  template <typename Test, typename Visitor>
+  void traverse(Test test, Visitor f) const;
+
+protected:
+  std::vector<Node> _nodes;
+  std::vector<int> _primitiveIds;
+
+  BVHBase() = default;
+
+  /// Builds this BVH over primitives with bounds \c primitiveBounds.
+  void build(const std::vector<Bounds3f>& primitiveBounds,
+    int maxPrimitivesPerNode);
+
+  static bool intersect(const Bounds3f& bounds,
+    const Ray& ray,
+    const vec3f& invDir,
+    float tMax,
+    float& tEntry)
+  {
+    auto tMin = ray.tMin;
+
+    for (int i = 0; i < 3; ++i)
+    {
+      auto t1 = (bounds.min()[i] - ray.origin[i]) * invDir[i];
+      auto t2 = (bounds.max()[i] - ray.origin[i]) * invDir[i];
+
+      if (t1 > t2)
+        std::swap(t1, t2);
+      tMin = t1 > tMin ? t1 : tMin;
+      tMax = t2 < tMax ? t2 : tMax;
+      if (tMin > tMax)
+        return false;
+    }
+    tEntry = tMin;
+    return true;
+  }
+
+}; // BVHBase
+
+template <typename Visitor>
+bool
+BVHBase::traverse(const Ray& ray, Visitor f) const
+{
+  if (_nodes.empty())
+    return false;
+
+  const vec3f invDir{math::inverse(ray.direction.x),
+    math::inverse(ray.direction.y),
+    math::inverse(ray.direction.z)};
+  auto tMax = ray.tMax;
+  float tEntry;
+
+  if (!intersect(_nodes[0].bounds, ray, invDir, tMax, tEntry))
+    return false;
+
+  int stack[maxDepth];
+  int top = 0;
+  int node = 0;
+
+  for (;;)
+  {
+    const auto& n = _nodes[node];
+
+    if (n.isLeaf())
+    {
+      auto id = _primitiveIds.data() + n.first;
+
+      for (auto e = id + n.count; id != e; ++id)
+        if (f(*id, tMax))
+          return true;
+    }
+    else
+    {
+      // Visit the nearest child first and push the farthest one
+      auto c1 = node + 1;
+      auto c2 = n.first;
+      float t1, t2;
+      auto hit1 = intersect(_nodes[c1].bounds, ray, invDir, tMax, t1);
+      auto hit2 = intersect(_nodes[c2].bounds, ray, invDir, tMax, t2);
+
+      if (hit1 && hit2)
+      {
+        if (t2 < t1)
+          std::swap(c1, c2);
+        stack[top++] = c2;
+        node = c1;
+        continue;
+      }
+      if (hit1 || hit2)
+      {
+        node = hit1 ? c1 : c2;
+        continue;
+      }
+    }
+    if (top == 0)
+      break;
+    node = stack[--top];
+  }
+  return false;
+}
+
+template <typename Test, typename Visitor>
+void
+BVHBase::traverse(Test test, Visitor f) const
+{
+  if (_nodes.empty() || !test(_nodes[0].bounds))
+    return;
+
+  int stack[maxDepth];
+  int top = 0;
+  int node = 0;
+
+  for (;;)
+  {
+    const auto& n = _nodes[node];
+
+    if (n.isLeaf())
+    {
+      auto id = _primitiveIds.data() + n.first;
+
+      for (auto e = id + n.count; id != e; ++id)
+        f(*id);
+    }
+    else
+    {
+      auto c1 = node + 1;
+      auto c2 = n.first;
+      auto in1 = test(_nodes[c1].bounds);
+      auto in2 = test(_nodes[c2].bounds);
+
+      if (in1 && in2)
+      {
+        stack[top++] = c2;
+        node = c1;
+        continue;
+      }
+      if (in1 || in2)
+      {
+        node = in1 ? c1 : c2;
+        continue;
+      }
+    }
+    if (top == 0)
+      break;
+    node = stack[--top];
+  }
+}
+
+
+//////////////////////////////////////////////////////////
+//
+// BVH: triangle mesh bounding volume hierarchy class
+// ===
+class BVH: public BVHBase
+{
+public:
+  /// Intersection record.
+  struct Hit
+  {
+    int triangleIndex;
+    /// Barycentric coordinates of the hit point, i.e., the weights of
+    /// the vertices 0, 1 and 2 of the triangle (see triangle::interpolate).
+    vec3f p;
+    float distance;
+
+  }; // Hit
+
+  /// Builds a BVH over the triangles of \c mesh.
+  BVH(TriangleMesh& mesh, int maxTrianglesPerNode = 4);
+
+  /// Returns the mesh of this BVH.
+  const TriangleMesh* mesh() const
+  {
+    return _mesh;
+  }
+
+  /// \brief Returns true if \c ray intersects a triangle in the range
+  /// [ray.tMin, ray.tMax]. In this case, \c hit is the closest one.
+  /// The ray direction need not be normalized.
+  bool intersect(const Ray& ray, Hit& hit) const;
+
+  /// Returns true if \c ray intersects any triangle (e.g., for shadows).
+  bool intersect(const Ray& ray) const;
+
+  /// Intersects \c ray and the triangle \c i of the mesh.
+  bool intersectTriangle(const Ray& ray, int i, Hit& hit) const;
+
+private:
+  Reference<TriangleMesh> _mesh;
+
+}; // BVH
+
+} // end namespace cg
+
+#endif // __BVH_h
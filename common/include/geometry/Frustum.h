@@ -0,0 +1,122 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: Frustum.h
+// ========
+// Class definition for view frustum.
+//
+// Author: Paulo Pagliosa
+// Last revision: 17/10/2026
+
+#ifndef __Frustum_h
+#define __Frustum_h
+
+#include "geometry/Bounds3.h"
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// Frustum: view frustum class
+// =======
+//
+// Six planes bounding the view volume of a view-projection matrix,
+// extracted from the rows of the matrix as in clip space the volume is
+// -w <= x, y, z <= w. The plane normals point inward.
+template <typename real>
+class Frustum
+{
+public:
+  using vec3 = Vector3<real>;
+  using vec4 = Vector4<real>;
+  using mat4 = Matrix4x4<real>;
+  using bounds3 = Bounds3<real>;
+
+  /// Constructs the frustum of the view-projection matrix \c m.
+  Frustum(const mat4& m)
+  {
+    // The columns of the transposed are the rows of m
+    const auto r = m.transposed();
+
+    _planes[0] = r[3] + r[0]; // left
+    _planes[1] = r[3] - r[0]; // right
+    _planes[2] = r[3] + r[1]; // bottom
+    _planes[3] = r[3] - r[1]; // top
+    _planes[4] = r[3] + r[2]; // near
+    _planes[5] = r[3] - r[2]; // far
+  }
+
+  /// Returns the plane \c i of this frustum.
+  const vec4& plane(int i) const
+  {
+    return _planes[i];
+  }
+
+  /// \brief Returns true if \c b is not entirely behind a plane of this
+  /// frustum. Boxes near the corners of the frustum may pass the test
+  /// while being out of it, which is conservative for culling.
+  bool intersects(const bounds3& b) const
+  {
+    for (const auto& p : _planes)
+    {
+      // Test the corner of b farthest along the plane normal
+      const auto x = p.x >= 0 ? b.max().x : b.min().x;
+      const auto y = p.y >= 0 ? b.max().y : b.min().y;
+      const auto z = p.z >= 0 ? b.max().z : b.min().z;
+
+      if (p.x * x + p.y * y + p.z * z + p.w < 0)
+        return false;
+    }
+    return true;
+  }
+
+  /// Returns true if \c b is entirely inside this frustum.
+  bool contains(const bounds3& b) const
+  {
+    for (const auto& p : _planes)
+    {
+      // Test the corner of b nearest along the plane normal
+      const auto x = p.x >= 0 ? b.min().x : b.max().x;
+      const auto y = p.y >= 0 ? b.min().y : b.max().y;
+      const auto z = p.z >= 0 ? b.min().z : b.max().z;
+
+      if (p.x * x + p.y * y + p.z * z + p.w < 0)
+        return false;
+    }
+    return true;
+  }
+
+private:
+  vec4 _planes[6];
+
+}; // Frustum
+
+using Frustumf = Frustum<float>;
+
+} // end namespace cg
+
+#endif // __Frustum_h
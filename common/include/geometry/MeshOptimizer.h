@@ -0,0 +1,114 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: MeshOptimizer.h
+// ========
+// Class definition for mesh optimizer.
+//
+// Author: Paulo Pagliosa
+// Last revision: 17/10/2026
+
+#ifndef __MeshOptimizer_h
+#define __MeshOptimizer_h
+
+#include "geometry/TriangleMesh.h"
+#include <vector>
+
+namespace cg
+{ // begin namespace cg
+
+
+//////////////////////////////////////////////////////////
+//
+// MeshOptimizer: mesh optimizer class
+// =============
+//
+// Reorders the triangles of a mesh for the post-transform vertex cache
+// of the GPU (Tipsify, Sander et al.), and then the vertices in the
+// order they are first referenced by the triangles, so that the vertex
+// fetches are sequential. The efficiency of the cache is measured by
+// the ACMR (average cache miss ratio, the number of transformed
+// vertices per triangle) and the ATVR (average transformed vertex
+// ratio, the number of transformed vertices per vertex, at best 1),
+// both computed by simulating a FIFO cache. The reordering is split
+// into clusters where it reaches a dead end; sorting the clusters so
+// that those facing outwards come first reduces the overdraw from any
+// viewpoint, at the cost of a few cache misses at the cluster seams.
+class MeshOptimizer
+{
+public:
+  /// Default number of entries of the simulated vertex cache.
+  static constexpr int cacheSize = 16;
+  /// \brief Default factor of the ACMR of a cluster below which the
+  /// cluster is split when sorted for overdraw.
+  static constexpr float overdrawThreshold = 1.05f;
+
+  struct Stats
+  {
+    float acmr;
+    float atvr;
+
+  }; // Stats
+
+  /// Returns the vertex cache statistics of the mesh \c data.
+  static Stats analyze(const TriangleMesh::Data& data,
+    int cacheSize = MeshOptimizer::cacheSize);
+
+  /// \brief Reorders the triangles of the mesh \c data for the vertex
+  /// cache. If \c clusters is not null, it receives the index of the
+  /// first triangle of each cluster of the new order.
+  static void optimizeVertexCache(TriangleMesh::Data& data,
+    int cacheSize = MeshOptimizer::cacheSize,
+    std::vector<int>* clusters = nullptr);
+
+  /// \brief Sorts the \c clusters of triangles of the mesh \c data,
+  /// given by the index of their first triangles, outwards facing
+  /// clusters first, to reduce the overdraw. A cluster is split where
+  /// the ACMR from its start falls below \c threshold times its ACMR.
+  static void optimizeOverdraw(TriangleMesh::Data& data,
+    const std::vector<int>& clusters,
+    float threshold = MeshOptimizer::overdrawThreshold,
+    int cacheSize = MeshOptimizer::cacheSize);
+
+  /// \brief Reorders the vertices (and normals, if any) of the mesh
+  /// \c data in the order they are first referenced by the triangles.
+  /// Vertices not referenced are moved to the end.
+  static void optimizeVertexFetch(TriangleMesh::Data& data);
+
+  /// Optimizes the vertex cache, overdraw and vertex fetch of \c data.
+  static void optimize(TriangleMesh::Data& data)
+  {
+    std::vector<int> clusters;
+
+    optimizeVertexCache(data, cacheSize, &clusters);
+    optimizeOverdraw(data, clusters);
+    optimizeVertexFetch(data);
+  }
+
+}; // MeshOptimizer
+
+} // end namespace cg
+
+#endif // __MeshOptimizer_h
@@ -0,0 +1,150 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: MeshSimplifier.h
+// ========
+// Class definition for quadric mesh simplifier.
+//
+// Author: Paulo Pagliosa
+// Last revision: 17/10/2026
+
+#ifndef __MeshSimplifier_h
+#define __MeshSimplifier_h
+
+#include "geometry/TriangleMesh.h"
+#include <vector>
+
+namespace cg
+{ // begin namespace cg
+
+
+//////////////////////////////////////////////////////////
+//
+// MeshSimplifier: quadric mesh simplifier class
+// ==============
+//
+// Simplifies a triangle mesh by edge collapses in order of increasing
+// quadric error (Garland and Heckbert). The quadric of a vertex sums
+// the squared distances to the planes of its triangles, weighted by
+// their areas, and to planes through the boundary edges orthogonal to
+// their triangles, so that open borders are kept. Vertices sharing a
+// position, as the ones of seams split by normals, are kept in place
+// so that no crack is opened between the sides of a seam. Collapses
+// which flip a triangle or make the mesh nonmanifold are rejected.
+//
+// The quadric error, a weighted mean of squared distances, only orders
+// the collapses. The error of the simplified mesh is a bound on its
+// distance to the original one: each vertex keeps the error of the
+// surface around it, which a collapse raises by the distance from the
+// new vertex to the farthest plane of the triangles it replaces.
+class MeshSimplifier
+{
+public:
+  /// Constructs a simplifier of the mesh \c data, which is copied.
+  MeshSimplifier(const TriangleMesh::Data& data);
+
+  /// \brief Collapses edges until the mesh has at most \c triangleCount
+  /// triangles or no edge can be collapsed. Returns the number of
+  /// triangles left. Calls can be chained to coarser and coarser meshes.
+  int simplify(int triangleCount);
+
+  /// Returns the number of triangles of the simplified mesh.
+  int triangleCount() const
+  {
+    return _triangleCount;
+  }
+
+  /// \brief Returns a bound on the distance from the simplified mesh to
+  /// the original one, in the units of the mesh.
+  float error() const
+  {
+    return _maxError;
+  }
+
+  /// Returns a new mesh with the vertices and triangles left.
+  TriangleMesh* mesh() const;
+
+  /// \brief Builds the levels of detail of \c mesh, each with about
+  /// \c ratio times the triangles of the previous one, while they have
+  /// at least \c minTriangleCount triangles (see TriangleMesh::lod).
+  static void buildLODs(TriangleMesh& mesh,
+    float ratio = 0.25f,
+    int minTriangleCount = 256);
+
+private:
+  // Symmetric 4x4 matrix of the quadric and sum of the plane weights
+  struct Quadric
+  {
+    double xx, xy, xz, xw, yy, yz, yw, zz, zw, ww;
+    double weight;
+
+    void setPlane(const vec3d& n, double d, double w);
+    Quadric& operator +=(const Quadric&);
+    double error(const vec3d&) const;
+    bool minimize(vec3d&) const;
+
+  }; // Quadric
+
+  struct Collapse
+  {
+    float cost;
+    int v0;
+    int v1;
+    int stamp0;
+    int stamp1;
+    vec3f p;
+
+    bool operator >(const Collapse& other) const
+    {
+      return cost > other.cost;
+    }
+
+  }; // Collapse
+
+  std::vector<vec3f> _vertices;
+  std::vector<TriangleMesh::Triangle> _triangles;
+  std::vector<char> _removed;
+  std::vector<char> _locked;
+  std::vector<Quadric> _quadrics;
+  std::vector<std::vector<int>> _vertexTriangles;
+  std::vector<int> _stamps;
+  std::vector<float> _errors;
+  std::vector<Collapse> _heap;
+  std::vector<int> _neighbors[2];
+  int _triangleCount;
+  float _maxError{};
+
+  void push(int, int);
+  void neighbors(int, std::vector<int>&) const;
+  bool isValid(const Collapse&);
+  bool flips(int, int, const vec3f&) const;
+  double distance(int, const vec3f&) const;
+  void collapse(const Collapse&);
+
+}; // MeshSimplifier
+
+} // end namespace cg
+
+#endif // __MeshSimplifier_h
@@ -0,0 +1,361 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: RayPacket.h
+// ========
+// Class definition for ray packet and SIMD intersection kernels.
+//
+// Author: Paulo Pagliosa
+// Last revision: 17/10/2026
+
+#ifndef __RayPacket_h
+#define __RayPacket_h
+
+#include "geometry/Bounds3.h"
+#include "math/SIMD.h"
+
+namespace cg
+{ // begin namespace cg
+
+//
+// Packets store their data as structures of arrays, one array of N
+// lanes per component, aligned for SIMD loads. Kernels return a
+// bitmask with the bit i set if the lane i hits, and write their
+// per-lane outputs to arrays of N floats, which need not be aligned.
+//
+// Slab tests order min/max operands so that the NaN produced by a zero
+// direction component with the origin on a slab plane is discarded.
+//
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// RayPacket: packet of N rays
+// =========
+template <int N>
+struct RayPacket
+{
+  alignas(32) float origin[3][N];
+  alignas(32) float direction[3][N];
+  alignas(32) float invDirection[3][N];
+  alignas(32) float tMin[N];
+  alignas(32) float tMax[N];
+
+  /// Sets the lane i to \c ray.
+  void set(int i, const Ray& ray)
+  {
+    for (int k = 0; k < 3; ++k)
+    {
+      origin[k][i] = ray.origin[k];
+      direction[k][i] = ray.direction[k];
+      invDirection[k][i] = math::inverse(ray.direction[k]);
+    }
+    tMin[i] = ray.tMin;
+    tMax[i] = ray.tMax;
+  }
+
+}; // RayPacket
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// BoundsPacket: packet of N boxes (e.g., children of a wide BVH node)
+// ============
+template <int N>
+struct BoundsPacket
+{
+  alignas(32) float min[3][N];
+  alignas(32) float max[3][N];
+
+  /// Constructs a packet of empty boxes, which are never hit.
+  BoundsPacket()
+  {
+    for (int i = 0; i < N; ++i)
+      set(i, Bounds3f{});
+  }
+
+  /// Sets the lane i to \c b.
+  void set(int i, const Bounds3f& b)
+  {
+    for (int k = 0; k < 3; ++k)
+    {
+      min[k][i] = b.min()[k];
+      max[k][i] = b.max()[k];
+    }
+  }
+
+}; // BoundsPacket
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// TrianglePacket: packet of N triangles
+// ==============
+template <int N>
+struct TrianglePacket
+{
+  alignas(32) float p0[3][N];
+  alignas(32) float e1[3][N];
+  alignas(32) float e2[3][N];
+
+  /// Constructs a packet of degenerate triangles, which are never hit.
+  TrianglePacket()
+  {
+    for (int k = 0; k < 3; ++k)
+      for (int i = 0; i < N; ++i)
+        p0[k][i] = e1[k][i] = e2[k][i] = 0;
+  }
+
+  /// Sets the lane i to the triangle (v0, v1, v2).
+  void set(int i, const vec3f& v0, const vec3f& v1, const vec3f& v2)
+  {
+    for (int k = 0; k < 3; ++k)
+    {
+      p0[k][i] = v0[k];
+      e1[k][i] = v1[k] - v0[k];
+      e2[k][i] = v2[k] - v0[k];
+    }
+  }
+
+}; // TrianglePacket
+
+namespace internal
+{ // begin namespace internal
+
+template <int N>
+struct vvec3
+{
+  simd::vfloat<N> x, y, z;
+
+  vvec3() = default;
+
+  vvec3(const simd::vfloat<N>& x,
+    const simd::vfloat<N>& y,
+    const simd::vfloat<N>& z):
+    x{x}, y{y}, z{z}
+  {
+    // do nothing
+  }
+
+  vvec3(const vec3f& v):
+    x{v.x}, y{v.y}, z{v.z}
+  {
+    // do nothing
+  }
+
+  static vvec3 load(const float p[3][N])
+  {
+    using vf = simd::vfloat<N>;
+    return {vf::load(p[0]), vf::load(p[1]), vf::load(p[2])};
+  }
+
+  vvec3 operator -(const vvec3& b) const
+  {
+    return {x - b.x, y - b.y, z - b.z};
+  }
+
+  simd::vfloat<N> dot(const vvec3& b) const
+  {
+    return x * b.x + y * b.y + z * b.z;
+  }
+
+  vvec3 cross(const vvec3& b) const
+  {
+    return {y * b.z - z * b.y, z * b.x - x * b.z, x * b.y - y * b.x};
+  }
+
+}; // vvec3
+
+template <int N>
+inline simd::vmask<N>
+slabs(const vvec3<N>& p1,
+  const vvec3<N>& p2,
+  const vvec3<N>& origin,
+  const vvec3<N>& invDir,
+  simd::vfloat<N> tMin,
+  simd::vfloat<N> tMax,
+  simd::vfloat<N>& tEntry)
+{
+  auto tx1 = (p1.x - origin.x) * invDir.x;
+  auto tx2 = (p2.x - origin.x) * invDir.x;
+  auto ty1 = (p1.y - origin.y) * invDir.y;
+  auto ty2 = (p2.y - origin.y) * invDir.y;
+  auto tz1 = (p1.z - origin.z) * invDir.z;
+  auto tz2 = (p2.z - origin.z) * invDir.z;
+
+  tMin = max(min(tx1, tx2), tMin);
+  tMax = min(max(tx1, tx2), tMax);
+  tMin = max(min(ty1, ty2), tMin);
+  tMax = min(max(ty1, ty2), tMax);
+  tMin = max(min(tz1, tz2), tMin);
+  tMax = min(max(tz1, tz2), tMax);
+  tEntry = tMin;
+  return tMin <= tMax;
+}
+
+template <int N>
+inline simd::vmask<N>
+mollerTrumbore(const vvec3<N>& p0,
+  const vvec3<N>& e1,
+  const vvec3<N>& e2,
+  const vvec3<N>& origin,
+  const vvec3<N>& direction,
+  const simd::vfloat<N>& tMin,
+  const simd::vfloat<N>& tMax,
+  float* t,
+  float* b1,
+  float* b2)
+{
+  using vf = simd::vfloat<N>;
+
+  const auto p = direction.cross(e2);
+  const auto d = e1.dot(p);
+  const auto invD = vf{1} / d;
+  const auto s = origin - p0;
+  const auto u = s.dot(p) * invD;
+  const auto q = s.cross(e1);
+  const auto v = direction.dot(q) * invD;
+  const auto distance = e2.dot(q) * invD;
+  const vf zero{0};
+  auto mask = (abs(d) > vf{math::Limits<float>::eps()}) &
+    (u >= zero) & (v >= zero) & (u + v <= vf{1}) &
+    (distance >= tMin) & (distance <= tMax);
+
+  distance.storeu(t);
+  u.storeu(b1);
+  v.storeu(b2);
+  return mask;
+}
+
+} // end namespace internal
+
+/// \brief Intersects the rays of \c packet and the box \c b. The entry
+/// distance of a ray hitting the box is stored in \c tEntry.
+template <int N>
+inline int
+intersect(const Bounds3f& b, const RayPacket<N>& packet, float* tEntry)
+{
+  using vf = simd::vfloat<N>;
+  using vec = internal::vvec3<N>;
+  vf t;
+  auto mask = internal::slabs<N>(vec{b.min()},
+    vec{b.max()},
+    vec::load(packet.origin),
+    vec::load(packet.invDirection),
+    vf::load(packet.tMin),
+    vf::load(packet.tMax),
+    t);
+
+  t.storeu(tEntry);
+  return mask.bits();
+}
+
+/// \brief Intersects \c ray, whose inverse direction is \c invDir, and
+/// the boxes of \c packet, up to the distance \c tMax. The entry
+/// distance of a box hit by the ray is stored in \c tEntry.
+template <int N>
+inline int
+intersect(const BoundsPacket<N>& packet,
+  const Ray& ray,
+  const vec3f& invDir,
+  float tMax,
+  float* tEntry)
+{
+  using vf = simd::vfloat<N>;
+  using vec = internal::vvec3<N>;
+  vf t;
+  auto mask = internal::slabs<N>(vec::load(packet.min),
+    vec::load(packet.max),
+    vec{ray.origin},
+    vec{invDir},
+    vf{ray.tMin},
+    vf{tMax},
+    t);
+
+  t.storeu(tEntry);
+  return mask.bits();
+}
+
+/// \brief Intersects the rays of \c packet and the triangle (v0, v1, v2)
+/// (Moller-Trumbore). For a ray i hitting the triangle, t[i] is the
+/// distance and (b1[i], b2[i]) are the barycentric coordinates of the
+/// hit point relative to v1 and v2.
+template <int N>
+inline int
+intersect(const vec3f& v0,
+  const vec3f& v1,
+  const vec3f& v2,
+  const RayPacket<N>& packet,
+  float* t,
+  float* b1,
+  float* b2)
+{
+  using vf = simd::vfloat<N>;
+  using vec = internal::vvec3<N>;
+
+  return internal::mollerTrumbore<N>(vec{v0},
+    vec{v1 - v0},
+    vec{v2 - v0},
+    vec::load(packet.origin),
+    vec::load(packet.direction),
+    vf::load(packet.tMin),
+    vf::load(packet.tMax),
+    t,
+    b1,
+    b2).bits();
+}
+
+/// \brief Intersects \c ray and the triangles of \c packet up to the
+/// distance \c tMax (Moller-Trumbore). For a triangle i hit by the ray,
+/// t[i] is the distance and (b1[i], b2[i]) are the barycentric
+/// coordinates of the hit point relative to its second and third
+/// vertices.
+template <int N>
+inline int
+intersect(const TrianglePacket<N>& packet,
+  const Ray& ray,
+  float tMax,
+  float* t,
+  float* b1,
+  float* b2)
+{
+  using vf = simd::vfloat<N>;
+  using vec = internal::vvec3<N>;
+
+  return internal::mollerTrumbore<N>(vec::load(packet.p0),
+    vec::load(packet.e1),
+    vec::load(packet.e2),
+    vec{ray.origin},
+    vec{ray.direction},
+    vf{ray.tMin},
+    vf{tMax},
+    t,
+    b1,
+    b2).bits();
+}
+
+} // end namespace cg
+
+#endif // __RayPacket_h
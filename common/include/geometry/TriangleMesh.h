@@ -161,10 +161,20 @@ public:
 
   const uint32_t id;
   Reference<SharedObject> userData;
+  /// Next coarser level of detail of this mesh, or null.
+  Reference<TriangleMesh> lod;
+  /// Distance error of this level of detail relative to the finest one.
+  float lodError{};
 
   /// Constructs a triangle mesh from data.
   TriangleMesh(const Data& data);
 
+  /// \brief Constructs a triangle mesh over arrays owned by \c storage,
+  /// e.g., the pages of a mapped file, which is kept alive by the mesh.
+  /// The arrays are not deleted by the mesh; \c data must include the
+  /// vertex normals.
+  TriangleMesh(const Data& data, const Bounds3f& bounds, SharedObject* storage);
+
   /// Destructor.
   ~TriangleMesh();
 
@@ -183,8 +193,28 @@ public:
     return _data.vertexNormals != nullptr;
   }
 
+  /// \brief Returns the coarsest level of detail of this mesh whose error
+  /// is at most \c maxError pixels when the bounds of this mesh span
+  /// \c size pixels on screen.
+  TriangleMesh* levelOfDetail(float size, float maxError = 1)
+  {
+    auto m = this;
+
+    if (lod == nullptr)
+      return m;
+
+    const auto scale = size / bounds().diagonalLength();
+
+    while (m->lod != nullptr && m->lod->lodError * scale <= maxError)
+      m = m->lod;
+    return m;
+  }
+
 private:
   Data _data;
+  Reference<SharedObject> _storage;
+  mutable Bounds3f _bounds;
+  mutable bool _hasBounds{};
 
 }; // TriangleMesh
 
@@ -0,0 +1,117 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: GLBuffer.h
+// ========
+// Class definition for GL buffer object.
+//
+// Author: Paulo Pagliosa
+// Last revision: 17/10/2026
+
+#ifndef __GLBuffer_h
+#define __GLBuffer_h
+
+#include "graphics/GLProgram.h"
+
+namespace cg
+{ // begin namespace cg
+
+
+//////////////////////////////////////////////////////////
+//
+// GLBuffer: GL buffer object class
+// ========
+//
+// Buffer streamed by the CPU, e.g., once per frame. Its store is
+// orphaned at each update, so that it does not wait for the draws
+// still reading the previous data. The buffer is created at the first
+// update, so that it can be declared before a GL context exists.
+class GLBuffer
+{
+public:
+  GLBuffer(GLenum target, GLenum usage = GL_STREAM_DRAW):
+    _target{target},
+    _usage{usage}
+  {
+    // do nothing
+  }
+
+  GLBuffer(const GLBuffer&) = delete;
+  GLBuffer& operator =(const GLBuffer&) = delete;
+
+  ~GLBuffer()
+  {
+    if (_handle != 0)
+      glDeleteBuffers(1, &_handle);
+  }
+
+  operator GLuint() const
+  {
+    return _handle;
+  }
+
+  void bind() const
+  {
+    glBindBuffer(_target, _handle);
+  }
+
+  /// Replaces the data of this buffer, which is bound.
+  void setData(const void* data, GLsizeiptr size)
+  {
+    if (_handle == 0)
+      glGenBuffers(1, &_handle);
+    bind();
+    if (size > _capacity)
+      _capacity = size;
+    glBufferData(_target, _capacity, nullptr, _usage);
+    glBufferSubData(_target, 0, size, data);
+  }
+
+  /// Binds a range of this buffer to an indexed binding point.
+  void bindRange(GLuint index, GLintptr offset, GLsizeiptr size) const
+  {
+    glBindBufferRange(_target, index, _handle, offset, size);
+  }
+
+  /// Returns the alignment of ranges bound to uniform binding points.
+  static GLint uniformOffsetAlignment()
+  {
+    GLint alignment;
+
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    return alignment;
+  }
+
+private:
+  GLenum _target;
+  GLenum _usage;
+  GLuint _handle{};
+  GLsizeiptr _capacity{};
+
+}; // GLBuffer
+
+} // end namespace cg
+
+#endif // __GLBuffer_h
@@ -63,6 +63,8 @@ public:
 
   void setPolygonMode(PolygonMode mode)
   {
+    // Triangles already drawn keep the previous mode
+    flush();
     glPolygonMode(GL_FRONT_AND_BACK, _polygonMode = mode);
   }
 
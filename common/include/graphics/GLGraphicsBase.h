@@ -35,6 +35,7 @@
 
 #include "Color.h"
 #include "GLProgram.h"
+#include <vector>
 
 namespace cg
 { // begin namespace cg
@@ -44,12 +45,20 @@ namespace cg
 //
 // GLGraphicsBase: OpenGL graphics base class
 // ==============
+//
+// Points, lines and triangles are not drawn at once, but appended to
+// batches drawn by flush() with a draw call per primitive type (and
+// per point size or line width). The vertices are written in a ring
+// buffer, orphaned only when it wraps around.
 class GLGraphicsBase
 {
 public:
   // Destructor.
   ~GLGraphicsBase();
 
+  // Draws the points, lines and triangles drawn since the last flush.
+  void flush();
+
   // Returns the point color.
   const Color& pointColor() const
   {
@@ -145,21 +154,47 @@ protected:
   void drawTriangle(const vec4f*);
 
 private:
+  struct Vertex
+  {
+    vec4f position;
+    Color color;
+
+  }; // Vertex
+
+  // Vertices of a primitive type, in runs of the same point size or
+  // line width
+  struct Batch
+  {
+    struct Run
+    {
+      int first;
+      int count;
+      float size;
+
+    }; // Run
+
+    std::vector<Vertex> vertices;
+    std::vector<Run> runs;
+
+    void add(const vec4f*, const Color*, int, float);
+
+  }; // Batch
+
   GLuint _vao;
-  GLSL::Program _pointDrawer;
+  GLuint _buffer;
+  GLsizeiptr _bufferSize{};
+  GLsizeiptr _bufferHead{};
+  GLSL::Program _drawer;
   Color _pointColor;
   float _pointSize;
-  GLint _pointLoc;
-  GLint _pointColorLoc;
-  GLSL::Program _lineDrawer;
   Color _lineColors[2];
   float _lineWidth;
-  GLint _linePointsLoc;
-  GLint _lineColorsLoc;
-  GLSL::Program _triangleDrawer;
   Color _triangleColors[3];
-  GLint _trianglePointsLoc;
-  GLint _triangleColorsLoc;
+  Batch _points;
+  Batch _lines;
+  Batch _triangles;
+
+  void draw(const Batch&, GLenum, GLint);
 
 }; // GLGraphicsBase
 
@@ -35,6 +35,11 @@
 
 #include "geometry/TriangleMesh.h"
 #include "graphics/GLProgram.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 namespace cg
 { // begin namespace cg
@@ -44,10 +49,23 @@ namespace cg
 //
 // GLMesh GL mesh array object class
 // ======
+//
+// A mesh is stored either with 32-bit float positions and normals in
+// separate buffers and 32-bit indices (24 bytes per vertex and 12 per
+// triangle), or, if compact, in a single interleaved buffer with the
+// positions quantized to 16 bits in the bounds of the mesh and the
+// normals packed in 10:10:10:2 format, and with 16-bit indices when
+// there are less than 65536 vertices (12 bytes per vertex and 6 per
+// triangle). Both attributes reach the shaders as floats; the positions
+// of a compact mesh are in [0,1] and must be transformed by
+// positionMatrix(), which is the identity for a float mesh.
 class GLMesh: public SharedObject
 {
 public:
-  GLMesh(const TriangleMesh& mesh)
+  GLMesh(const TriangleMesh& mesh, bool compact = false):
+    _positionMatrix{mat4f::identity()},
+    _indexType{GL_UNSIGNED_INT},
+    _compact{compact}
   {
     glGenVertexArrays(1, &_vao);
     glBindVertexArray(_vao);
@@ -55,22 +73,10 @@ public:
 
     const auto& m = mesh.data();
 
-    if (auto s = size<vec3f>(m.numberOfVertices))
-    {
-      glBindBuffer(GL_ARRAY_BUFFER, _buffers[0]);
-      glBufferData(GL_ARRAY_BUFFER, s, m.vertices, GL_STATIC_DRAW);
-      glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
-      glEnableVertexAttribArray(0);
-      glBindBuffer(GL_ARRAY_BUFFER, _buffers[1]);
-      glBufferData(GL_ARRAY_BUFFER, s, m.vertexNormals, GL_STATIC_DRAW);
-      glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, 0);
-      glEnableVertexAttribArray(1);
-    }
-    if (auto s = size<TriangleMesh::Triangle>(m.numberOfTriangles))
-    {
-      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffers[2]);
-      glBufferData(GL_ELEMENT_ARRAY_BUFFER, s, m.triangles, GL_STATIC_DRAW);
-    }
+    if (compact)
+      initCompact(mesh);
+    else
+      initFloat(m);
     _vertexCount = m.numberOfTriangles * 3;
   }
 
@@ -90,10 +96,62 @@ public:
     return _vertexCount;
   }
 
+  /// Returns the type of the indices, to be passed to glDrawElements().
+  auto indexType() const
+  {
+    return _indexType;
+  }
+
+  /// Returns true if the vertices of this mesh are quantized.
+  bool isCompact() const
+  {
+    return _compact;
+  }
+
+  /// \brief Returns the matrix which maps the vertex positions of this
+  /// mesh to the local space of the triangle mesh.
+  const mat4f& positionMatrix() const
+  {
+    return _positionMatrix;
+  }
+
+  auto vao() const
+  {
+    return _vao;
+  }
+
+  /// Returns true if the meshes created by glMesh() are compact.
+  static bool compactByDefault()
+  {
+    return defaultCompact();
+  }
+
+  /// Sets whether the meshes created by glMesh() are compact.
+  static void setCompactByDefault(bool compact)
+  {
+    defaultCompact() = compact;
+  }
+
 private:
+  struct CompactVertex
+  {
+    uint16_t position[4];
+    uint32_t normal;
+
+  }; // CompactVertex
+
   GLuint _vao;
   GLuint _buffers[3];
   int _vertexCount;
+  mat4f _positionMatrix;
+  GLenum _indexType;
+  bool _compact;
+
+  static bool& defaultCompact()
+  {
+    static bool compact;
+    return compact;
+  }
 
   template <typename T>
   static auto size(int n)
@@ -101,6 +159,114 @@ private:
     return sizeof(T) * n;
   }
 
+  void initFloat(const TriangleMesh::Data& m)
+  {
+    if (auto s = size<vec3f>(m.numberOfVertices))
+    {
+      glBindBuffer(GL_ARRAY_BUFFER, _buffers[0]);
+      glBufferData(GL_ARRAY_BUFFER, s, m.vertices, GL_STATIC_DRAW);
+      glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+      glEnableVertexAttribArray(0);
+      glBindBuffer(GL_ARRAY_BUFFER, _buffers[1]);
+      glBufferData(GL_ARRAY_BUFFER, s, m.vertexNormals, GL_STATIC_DRAW);
+      glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, 0);
+      glEnableVertexAttribArray(1);
+    }
+    if (auto s = size<TriangleMesh::Triangle>(m.numberOfTriangles))
+    {
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffers[2]);
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, s, m.triangles, GL_STATIC_DRAW);
+    }
+  }
+
+  static uint32_t packNormal(const vec3f& n)
+  {
+    auto pack = [](float x)
+    {
+      x = std::round(std::max(-1.0f, std::min(x, 1.0f)) * 511);
+      return uint32_t(int32_t(x)) & 0x3ff;
+    };
+
+    return pack(n.x) | pack(n.y) << 10 | pack(n.z) << 20;
+  }
+
+  void initCompact(const TriangleMesh& mesh)
+  {
+    const auto& m = mesh.data();
+    const auto nv = m.numberOfVertices;
+    const auto bounds = mesh.bounds();
+    const auto& p0 = bounds.min();
+    const auto s = bounds.size();
+    vec3f scale;
+
+    for (int i = 0; i < 3; ++i)
+      scale[i] = s[i] > 0 ? 65535 / s[i] : 0;
+    _positionMatrix = mat4f{vec4f{s.x / 65535, 0, 0, 0},
+      vec4f{0, s.y / 65535, 0, 0},
+      vec4f{0, 0, s.z / 65535, 0},
+      vec4f{p0, 1}};
+
+    std::vector<CompactVertex> vertices(nv);
+
+    for (int i = 0; i < nv; ++i)
+    {
+      auto& v = vertices[i];
+      const auto q = (m.vertices[i] - p0) * scale;
+
+      for (int k = 0; k < 3; ++k)
+        v.position[k] = uint16_t(std::min(q[k] + 0.5f, 65535.0f));
+      v.position[3] = 0;
+      v.normal = m.vertexNormals != nullptr ?
+        packNormal(m.vertexNormals[i]) :
+        0;
+    }
+    if (nv > 0)
+    {
+      constexpr auto stride = GLsizei(sizeof(CompactVertex));
+
+      glBindBuffer(GL_ARRAY_BUFFER, _buffers[0]);
+      glBufferData(GL_ARRAY_BUFFER,
+        size<CompactVertex>(nv),
+        vertices.data(),
+        GL_STATIC_DRAW);
+      glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, stride, 0);
+      glEnableVertexAttribArray(0);
+      glVertexAttribPointer(1,
+        4,
+        GL_INT_2_10_10_10_REV,
+        GL_TRUE,
+        stride,
+        (const void*)offsetof(CompactVertex, normal));
+      glEnableVertexAttribArray(1);
+    }
+
+    const auto ni = m.numberOfTriangles * 3;
+
+    if (ni == 0)
+      return;
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffers[2]);
+    if (nv >= 65536)
+    {
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+        size<TriangleMesh::Triangle>(m.numberOfTriangles),
+        m.triangles,
+        GL_STATIC_DRAW);
+      return;
+    }
+
+    std::vector<uint16_t> indices(ni);
+    auto index = indices.data();
+
+    for (int i = 0; i < m.numberOfTriangles; ++i)
+      for (auto v : m.triangles[i].v)
+        *index++ = uint16_t(v);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+      size<uint16_t>(ni),
+      indices.data(),
+      GL_STATIC_DRAW);
+    _indexType = GL_UNSIGNED_SHORT;
+  }
+
 }; // GLMesh
 
 inline GLMesh*
@@ -109,6 +275,9 @@ asGLMesh(SharedObject* object)
   return dynamic_cast<GLMesh*>(object);
 }
 
+/// \brief Returns the GL mesh of \c mesh, which is created the first
+/// time (see GLMesh::compactByDefault()). The GL mesh of a triangle mesh
+/// is released by setting its user data to null.
 inline GLMesh*
 glMesh(TriangleMesh* mesh)
 {
@@ -119,7 +288,7 @@ glMesh(TriangleMesh* mesh)
 
   if (nullptr == ma)
   {
-    ma = new GLMesh{*mesh};
+    ma = new GLMesh{*mesh, GLMesh::compactByDefault()};
     mesh->userData = ma;
   }
   return ma;
@@ -41,6 +41,7 @@
 #endif
 #include <GLFW/glfw3.h>
 #include <string>
+#include <unordered_map>
 
 namespace cg
 { // begin namespace cg
@@ -130,6 +131,12 @@ public:
   // Gets uniform variable location.
   GLint uniformLocation(const char*) const;
 
+  // Gets uniform block index.
+  GLuint uniformBlockIndex(const char*) const;
+
+  // Sets the binding point of a uniform block.
+  void setUniformBlockBinding(const char*, GLuint);
+
   // Sets uniform variable by location.
   static void setUniform(GLint, GLint);
   static void setUniform(GLint, float);
@@ -197,10 +204,15 @@ private:
   GLuint _handle;
   std::string _name;
   State _state;
+  // Locations of the uniforms, by name
+  mutable std::unordered_map<std::string, GLint> _uniforms;
 
   // Check if this program is in use.
   void checkInUse() const;
 
+  // Loads the locations of the active uniforms.
+  void loadUniforms();
+
 }; // Program
 
 inline void
@@ -0,0 +1,106 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: Image.h
+// ========
+// Class definition for RGB image.
+//
+// Author: Paulo Pagliosa
+// Last revision: 17/10/2026
+
+#ifndef __Image_h
+#define __Image_h
+
+#include "core/SharedObject.h"
+#include "graphics/Color.h"
+#include <vector>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// Image: RGB image class
+// =====
+//
+// Pixels are stored row by row, from the bottom row up, as in OpenGL.
+class Image: public SharedObject
+{
+public:
+  /// Constructs a black image of size w x h.
+  Image(int w, int h):
+    _width{w},
+    _height{h},
+    _pixels(size_t(w) * h, Color::black)
+  {
+    // do nothing
+  }
+
+  auto width() const
+  {
+    return _width;
+  }
+
+  auto height() const
+  {
+    return _height;
+  }
+
+  const Color* data() const
+  {
+    return _pixels.data();
+  }
+
+  /// Returns the pixel (x, y), with origin at the lower left corner.
+  const Color& operator ()(int x, int y) const
+  {
+    return _pixels[size_t(y) * _width + x];
+  }
+
+  Color& operator ()(int x, int y)
+  {
+    return _pixels[size_t(y) * _width + x];
+  }
+
+  /// Writes this image to a binary PPM (P6) file.
+  bool writePPM(const char* filename) const;
+
+  /// Writes this image to an uncompressed 24-bit PNG file.
+  bool writePNG(const char* filename) const;
+
+private:
+  int _width;
+  int _height;
+  std::vector<Color> _pixels;
+
+  /// Returns the 8-bit RGB rows of this image, from the top row down.
+  std::vector<unsigned char> rgb() const;
+
+}; // Image
+
+} // end namespace cg
+
+#endif // __Image_h
@@ -0,0 +1,509 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: SIMD.h
+// ========
+// Class definition for SIMD vectors.
+//
+// Author: Paulo Pagliosa
+// Last revision: 17/10/2026
+
+#ifndef __SIMD_h
+#define __SIMD_h
+
+#include <cmath>
+
+// SSE is always available on x64. AVX depends on the target
+// architecture (e.g., /arch:AVX2 or -mavx2). Define CG_NO_SIMD to use
+// the scalar fallback only.
+#ifndef CG_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CG_USE_SSE
+#include <emmintrin.h>
+#endif
+#ifdef __AVX__
+#define CG_USE_AVX
+#include <immintrin.h>
+#endif
+#endif // CG_NO_SIMD
+
+namespace cg
+{ // begin namespace cg
+
+namespace simd
+{ // begin namespace simd
+
+/// Widest vector width available.
+#if defined(CG_USE_AVX)
+constexpr int width = 8;
+#elif defined(CG_USE_SSE)
+constexpr int width = 4;
+#else
+constexpr int width = 1;
+#endif
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// vmask: SIMD mask class
+// =====
+//
+// Generic (scalar) implementation; SSE and AVX specializations follow.
+template <int N>
+struct vmask
+{
+  bool m[N];
+
+  vmask operator &(const vmask& b) const
+  {
+    vmask r;
+
+    for (int i = 0; i < N; ++i)
+      r.m[i] = m[i] && b.m[i];
+    return r;
+  }
+
+  vmask operator |(const vmask& b) const
+  {
+    vmask r;
+
+    for (int i = 0; i < N; ++i)
+      r.m[i] = m[i] || b.m[i];
+    return r;
+  }
+
+  /// Returns a bitmask with the bit i set if the lane i is set.
+  int bits() const
+  {
+    int b = 0;
+
+    for (int i = 0; i < N; ++i)
+      b |= int(m[i]) << i;
+    return b;
+  }
+
+}; // vmask
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// vfloat: SIMD float vector class
+// ======
+//
+// Generic (scalar) implementation; SSE and AVX specializations follow.
+template <int N>
+struct vfloat
+{
+  float v[N];
+
+  vfloat() = default;
+
+  vfloat(float s)
+  {
+    for (int i = 0; i < N; ++i)
+      v[i] = s;
+  }
+
+  static vfloat load(const float* p)
+  {
+    vfloat r;
+
+    for (int i = 0; i < N; ++i)
+      r.v[i] = p[i];
+    return r;
+  }
+
+  static vfloat loadu(const float* p)
+  {
+    return load(p);
+  }
+
+  void store(float* p) const
+  {
+    for (int i = 0; i < N; ++i)
+      p[i] = v[i];
+  }
+
+  void storeu(float* p) const
+  {
+    store(p);
+  }
+
+  /// Returns the lane i of this vector.
+  float operator [](int i) const
+  {
+    return v[i];
+  }
+
+#define CG_SIMD_OP(op) \
+  vfloat operator op(const vfloat& b) const \
+  { \
+    vfloat r; \
+    for (int i = 0; i < N; ++i) \
+      r.v[i] = v[i] op b.v[i]; \
+    return r; \
+  }
+  CG_SIMD_OP(+)
+  CG_SIMD_OP(-)
+  CG_SIMD_OP(*)
+  CG_SIMD_OP(/)
+#undef CG_SIMD_OP
+
+#define CG_SIMD_CMP(op) \
+  vmask<N> operator op(const vfloat& b) const \
+  { \
+    vmask<N> r; \
+    for (int i = 0; i < N; ++i) \
+      r.m[i] = v[i] op b.v[i]; \
+    return r; \
+  }
+  CG_SIMD_CMP(<)
+  CG_SIMD_CMP(<=)
+  CG_SIMD_CMP(>)
+  CG_SIMD_CMP(>=)
+  CG_SIMD_CMP(!=)
+#undef CG_SIMD_CMP
+
+  friend vfloat min(const vfloat& a, const vfloat& b)
+  {
+    vfloat r;
+
+    for (int i = 0; i < N; ++i)
+      r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i];
+    return r;
+  }
+
+  friend vfloat max(const vfloat& a, const vfloat& b)
+  {
+    vfloat r;
+
+    for (int i = 0; i < N; ++i)
+      r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i];
+    return r;
+  }
+
+  friend vfloat abs(const vfloat& a)
+  {
+    vfloat r;
+
+    for (int i = 0; i < N; ++i)
+      r.v[i] = std::fabs(a.v[i]);
+    return r;
+  }
+
+  /// Returns, for each lane, a if the lane of m is set, or b otherwise.
+  friend vfloat select(const vmask<N>& m, const vfloat& a, const vfloat& b)
+  {
+    vfloat r;
+
+    for (int i = 0; i < N; ++i)
+      r.v[i] = m.m[i] ? a.v[i] : b.v[i];
+    return r;
+  }
+
+}; // vfloat
+
+#ifdef CG_USE_SSE
+template <>
+struct vmask<4>
+{
+  __m128 m;
+
+  vmask operator &(const vmask& b) const
+  {
+    return {_mm_and_ps(m, b.m)};
+  }
+
+  vmask operator |(const vmask& b) const
+  {
+    return {_mm_or_ps(m, b.m)};
+  }
+
+  int bits() const
+  {
+    return _mm_movemask_ps(m);
+  }
+
+}; // vmask<4>
+
+template <>
+struct vfloat<4>
+{
+  __m128 v;
+
+  vfloat() = default;
+
+  vfloat(__m128 v):
+    v{v}
+  {
+    // do nothing
+  }
+
+  vfloat(float s):
+    v{_mm_set1_ps(s)}
+  {
+    // do nothing
+  }
+
+  static vfloat load(const float* p)
+  {
+    return _mm_load_ps(p);
+  }
+
+  static vfloat loadu(const float* p)
+  {
+    return _mm_loadu_ps(p);
+  }
+
+  void store(float* p) const
+  {
+    _mm_store_ps(p, v);
+  }
+
+  void storeu(float* p) const
+  {
+    _mm_storeu_ps(p, v);
+  }
+
+  float operator [](int i) const
+  {
+    alignas(16) float a[4];
+
+    _mm_store_ps(a, v);
+    return a[i];
+  }
+
+  vfloat operator +(const vfloat& b) const
+  {
+    return _mm_add_ps(v, b.v);
+  }
+
+  vfloat operator -(const vfloat& b) const
+  {
+    return _mm_sub_ps(v, b.v);
+  }
+
+  vfloat operator *(const vfloat& b) const
+  {
+    return _mm_mul_ps(v, b.v);
+  }
+
+  vfloat operator /(const vfloat& b) const
+  {
+    return _mm_div_ps(v, b.v);
+  }
+
+  vmask<4> operator <(const vfloat& b) const
+  {
+    return {_mm_cmplt_ps(v, b.v)};
+  }
+
+  vmask<4> operator <=(const vfloat& b) const
+  {
+    return {_mm_cmple_ps(v, b.v)};
+  }
+
+  vmask<4> operator >(const vfloat& b) const
+  {
+    return {_mm_cmpgt_ps(v, b.v)};
+  }
+
+  vmask<4> operator >=(const vfloat& b) const
+  {
+    return {_mm_cmpge_ps(v, b.v)};
+  }
+
+  vmask<4> operator !=(const vfloat& b) const
+  {
+    return {_mm_cmpneq_ps(v, b.v)};
+  }
+
+  friend vfloat min(const vfloat& a, const vfloat& b)
+  {
+    return _mm_min_ps(a.v, b.v);
+  }
+
+  friend vfloat max(const vfloat& a, const vfloat& b)
+  {
+    return _mm_max_ps(a.v, b.v);
+  }
+
+  friend vfloat abs(const vfloat& a)
+  {
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v);
+  }
+
+  friend vfloat select(const vmask<4>& m, const vfloat& a, const vfloat& b)
+  {
+    return _mm_or_ps(_mm_and_ps(m.m, a.v), _mm_andnot_ps(m.m, b.v));
+  }
+
+}; // vfloat<4>
+#endif // CG_USE_SSE
+
+#ifdef CG_USE_AVX
+template <>
+struct vmask<8>
+{
+  __m256 m;
+
+  vmask operator &(const vmask& b) const
+  {
+    return {_mm256_and_ps(m, b.m)};
+  }
+
+  vmask operator |(const vmask& b) const
+  {
+    return {_mm256_or_ps(m, b.m)};
+  }
+
+  int bits() const
+  {
+    return _mm256_movemask_ps(m);
+  }
+
+}; // vmask<8>
+
+template <>
+struct vfloat<8>
+{
+  __m256 v;
+
+  vfloat() = default;
+
+  vfloat(__m256 v):
+    v{v}
+  {
+    // do nothing
+  }
+
+  vfloat(float s):
+    v{_mm256_set1_ps(s)}
+  {
+    // do nothing
+  }
+
+  static vfloat load(const float* p)
+  {
+    return _mm256_load_ps(p);
+  }
+
+  static vfloat loadu(const float* p)
+  {
+    return _mm256_loadu_ps(p);
+  }
+
+  void store(float* p) const
+  {
+    _mm256_store_ps(p, v);
+  }
+
+  void storeu(float* p) const
+  {
+    _mm256_storeu_ps(p, v);
+  }
+
+  float operator [](int i) const
+  {
+    alignas(32) float a[8];
+
+    _mm256_store_ps(a, v);
+    return a[i];
+  }
+
+  vfloat operator +(const vfloat& b) const
+  {
+    return _mm256_add_ps(v, b.v);
+  }
+
+  vfloat operator -(const vfloat& b) const
+  {
+    return _mm256_sub_ps(v, b.v);
+  }
+
+  vfloat operator *(const vfloat& b) const
+  {
+    return _mm256_mul_ps(v, b.v);
+  }
+
+  vfloat operator /(const vfloat& b) const
+  {
+    return _mm256_div_ps(v, b.v);
+  }
+
+  vmask<8> operator <(const vfloat& b) const
+  {
+    return {_mm256_cmp_ps(v, b.v, _CMP_LT_OQ)};
+  }
+
+  vmask<8> operator <=(const vfloat& b) const
+  {
+    return {_mm256_cmp_ps(v, b.v, _CMP_LE_OQ)};
+  }
+
+  vmask<8> operator >(const vfloat& b) const
+  {
+    return {_mm256_cmp_ps(v, b.v, _CMP_GT_OQ)};
+  }
+
+  vmask<8> operator >=(const vfloat& b) const
+  {
+    return {_mm256_cmp_ps(v, b.v, _CMP_GE_OQ)};
+  }
+
+  vmask<8> operator !=(const vfloat& b) const
+  {
+    return {_mm256_cmp_ps(v, b.v, _CMP_NEQ_UQ)};
+  }
+
+  friend vfloat min(const vfloat& a, const vfloat& b)
+  {
+    return _mm256_min_ps(a.v, b.v);
+  }
+
+  friend vfloat max(const vfloat& a, const vfloat& b)
+  {
+    return _mm256_max_ps(a.v, b.v);
+  }
+
+  friend vfloat abs(const vfloat& a)
+  {
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v);
+  }
+
+  friend vfloat select(const vmask<8>& m, const vfloat& a, const vfloat& b)
+  {
+    return _mm256_blendv_ps(b.v, a.v, m.m);
+  }
+
+}; // vfloat<8>
+#endif // CG_USE_AVX
+
+} // end namespace simd
+
+} // end namespace cg
+
+#endif // __SIMD_h
@@ -0,0 +1,120 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: MappedFile.h
+// ========
+// Class definition for read-only memory-mapped file.
+//
+// Author: Paulo Pagliosa
+// Last revision: 17/10/2026
+
+#ifndef __MappedFile_h
+#define __MappedFile_h
+
+#include <cstddef>
+
+namespace cg
+{ // begin namespace cg
+
+
+//////////////////////////////////////////////////////////
+//
+// MappedFile: read-only memory-mapped file class
+// ==========
+class MappedFile
+{
+public:
+  /// Constructs a closed mapped file.
+  MappedFile() = default;
+
+  /// Constructs a mapped file and maps \c filename.
+  MappedFile(const char* filename, bool copyOnWrite = false)
+  {
+    open(filename, copyOnWrite);
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator =(const MappedFile&) = delete;
+
+  /// Destructor.
+  ~MappedFile()
+  {
+    close();
+  }
+
+  /// \brief Maps the whole \c filename into memory and returns true
+  /// on success. An empty file is opened with a null data pointer.
+  /// If \c copyOnWrite is true, the pages can be written through
+  /// writableData(); changes are private and never reach the file.
+  bool open(const char* filename, bool copyOnWrite = false);
+
+  /// Unmaps the file.
+  void close();
+
+  /// Returns true if this file is open.
+  bool isOpen() const
+  {
+    return _open;
+  }
+
+  /// Returns the beginning of the mapped pages.
+  const char* data() const
+  {
+    return _data;
+  }
+
+  /// Returns the beginning of the copy-on-write mapped pages.
+  char* writableData() const
+  {
+    return _copyOnWrite ? _data : nullptr;
+  }
+
+  /// Returns the past-the-end of the mapped pages.
+  const char* end() const
+  {
+    return _data + _size;
+  }
+
+  /// Returns the size of the file in bytes.
+  size_t size() const
+  {
+    return _size;
+  }
+
+private:
+  char* _data{};
+  size_t _size{};
+  bool _open{};
+  bool _copyOnWrite{};
+#ifdef _WIN32
+  void* _file{};
+  void* _mapping{};
+#endif
+
+}; // MappedFile
+
+} // end namespace cg
+
+#endif // __MappedFile_h
@@ -0,0 +1,79 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: MeshCache.h
+// ========
+// Class definition for binary mesh cache.
+//
+// Author: Paulo Pagliosa
+// Last revision: 17/10/2026
+
+#ifndef __MeshCache_h
+#define __MeshCache_h
+
+#include "geometry/TriangleMesh.h"
+
+namespace cg
+{ // begin namespace cg
+
+
+//////////////////////////////////////////////////////////
+//
+// MeshCache: binary mesh cache class
+// =========
+//
+// A cache file (.cgmesh) holds the TriangleMesh::Data and the bounds
+// of a mesh read from a source file, e.g., a Wavefront OBJ file, and of
+// its levels of detail (see TriangleMesh::lod). The vertex, normal and
+// triangle arrays are stored at 64-byte aligned offsets in the native
+// layout, so a cached mesh and its levels are built directly over the
+// mapped pages of the file without any parsing or simplification.
+//
+// A cache is valid while the size and the modification time of its
+// source are unchanged. If only the time differs, the cache is still
+// valid when the source has the hash recorded in the cache.
+class MeshCache
+{
+public:
+  static constexpr auto extension = ".cgmesh";
+  static constexpr uint32_t version = 3;
+
+  /// \brief Returns the mesh cached in \c filename, or null if the file
+  /// does not exist, is not a valid cache, or is outdated with respect
+  /// to \c sourceFilename.
+  static TriangleMesh* read(const char* filename, const char* sourceFilename);
+
+  /// \brief Writes \c mesh read from \c sourceFilename, with its levels
+  /// of detail, into the cache file \c filename and returns true on
+  /// success. The mesh and its levels must have vertex normals.
+  static bool write(const char* filename,
+    const char* sourceFilename,
+    const TriangleMesh& mesh);
+
+}; // MeshCache
+
+} // end namespace cg
+
+#endif // __MeshCache_h
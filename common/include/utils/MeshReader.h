@@ -46,7 +46,14 @@ namespace cg
 class MeshReader
 {
 public:
-  static TriangleMesh* readOBJ(const char* filename);
+  /// \brief Reads a Wavefront OBJ file. Files larger than a few MB are
+  /// split into line-aligned chunks parsed by up to \c threads workers
+  /// (0 means one per hardware thread); the result does not depend on
+  /// the number of threads. If \c optimize is true, the triangles and
+  /// vertices are reordered by MeshOptimizer.
+  static TriangleMesh* readOBJ(const char* filename,
+    int threads = 0,
+    bool optimize = true);
 
 }; // MeshReader
 
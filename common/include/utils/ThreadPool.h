@@ -0,0 +1,108 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: ThreadPool.h
+// ========
+// Class definition for work-stealing thread pool.
+//
+// Author: Paulo Pagliosa
+// Last revision: 17/10/2026
+
+#ifndef __ThreadPool_h
+#define __ThreadPool_h
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// ThreadPool: work-stealing thread pool class
+// ==========
+//
+// Runs batches of indexed tasks. Each thread owns a queue initially
+// holding a contiguous range of the tasks of a batch, takes tasks from
+// one end of its own queue and, once it is empty, steals tasks from the
+// other end of the queues of other threads.
+class ThreadPool
+{
+public:
+  using Task = std::function<void(int)>;
+
+  /// \brief Constructs a thread pool with \c threadCount threads, or as
+  /// many as the hardware threads if \c threadCount <= 0. The thread
+  /// calling run() is one of them.
+  ThreadPool(int threadCount = 0);
+
+  /// Destructor.
+  ~ThreadPool();
+
+  /// Returns the number of threads of this pool.
+  int size() const
+  {
+    return int(_queues.size());
+  }
+
+  /// \brief Runs task(i), for i in [0, n), on the threads of this pool
+  /// and returns when all of them are done.
+  void run(int n, const Task& task);
+
+private:
+  struct Queue
+  {
+    std::mutex mutex;
+    std::deque<int> tasks;
+
+  }; // Queue
+
+  std::vector<std::unique_ptr<Queue>> _queues;
+  std::vector<std::thread> _threads;
+  std::mutex _mutex;
+  std::condition_variable _start;
+  std::condition_variable _done;
+  const Task* _task{};
+  int _batch{};
+  int _remaining{};
+  int _active{};
+  bool _stop{};
+
+  bool pop(int queue, int& task);
+  bool steal(int queue, int& task);
+  int work(int queue, const Task&);
+  void loop(int queue);
+
+}; // ThreadPool
+
+} // end namespace cg
+
+#endif // __ThreadPool_h
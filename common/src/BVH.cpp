@@ -0,0 +1,344 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: BVH.cpp
+// ========
+// Source file for bounding volume hierarchy.
+//
+// Author: Paulo Pagliosa
+// Last revision: 17/10/2026
+
+#include "geometry/BVH.h"
+#include <algorithm>
+
+namespace cg
+{ // begin namespace cg
+
+namespace internal
+{ // begin namespace internal
+
+
+//////////////////////////////////////////////////////////
+//
+// BVHBuilder: binned SAH BVH builder
+// ==========
+class BVHBuilder
+{
+public:
+  using Node = BVHBase::Node;
+
+  BVHBuilder(const std::vector<Bounds3f>& primitiveBounds,
+    int maxPrimitivesPerNode,
+    std::vector<Node>& nodes,
+    std::vector<int>& primitiveIds):
+    _primitiveBounds{primitiveBounds},
+    _maxPrimitivesPerNode{std::max(maxPrimitivesPerNode, 1)},
+    _nodes{nodes},
+    _primitiveIds{primitiveIds}
+  {
+    // do nothing
+  }
+
+  void build();
+
+private:
+  static constexpr int binCount = 16;
+  // Relative cost of a ray-box test against a ray-primitive test
+  static constexpr float traversalCost = 1;
+
+  struct Bin
+  {
+    Bounds3f bounds;
+    int count{};
+
+  }; // Bin
+
+  const std::vector<Bounds3f>& _primitiveBounds;
+  int _maxPrimitivesPerNode;
+  std::vector<Node>& _nodes;
+  std::vector<int>& _primitiveIds;
+  std::vector<vec3f> _centroids;
+
+  void makeNode(int node, int first, int count, int depth);
+  void makeLeaf(int node, int first, int count);
+
+}; // BVHBuilder
+
+void
+BVHBuilder::build()
+{
+  const auto n = int(_primitiveBounds.size());
+
+  _nodes.clear();
+  _primitiveIds.resize(n);
+  if (n == 0)
+    return;
+  _centroids.resize(n);
+  for (int i = 0; i < n; ++i)
+  {
+    _centroids[i] = _primitiveBounds[i].center();
+    _primitiveIds[i] = i;
+  }
+  // A binary tree with at most n leaves has at most 2n - 1 nodes
+  _nodes.reserve(2 * n - 1);
+  _nodes.emplace_back();
+  makeNode(0, 0, n, 1);
+  _nodes.shrink_to_fit();
+}
+
+inline void
+BVHBuilder::makeLeaf(int node, int first, int count)
+{
+  auto& leaf = _nodes[node];
+
+  leaf.first = first;
+  leaf.count = count;
+}
+
+void
+BVHBuilder::makeNode(int node, int first, int count, int depth)
+{
+  auto* ids = _primitiveIds.data() + first;
+  Bounds3f bounds;
+  Bounds3f centroidBounds;
+
+  for (int i = 0; i < count; ++i)
+  {
+    bounds.inflate(_primitiveBounds[ids[i]]);
+    centroidBounds.inflate(_centroids[ids[i]]);
+  }
+  _nodes[node].bounds = bounds;
+  // The traversal stack holds at most one node per level
+  if (count <= _maxPrimitivesPerNode || depth >= BVHBase::maxDepth)
+    return makeLeaf(node, first, count);
+
+  // Find the best split plane among the bin boundaries of all axes
+  const auto& cMin = centroidBounds.min();
+  const auto cSize = centroidBounds.size();
+  int bestAxis = -1;
+  int bestSplit = 0;
+  float bestCost = math::Limits<float>::inf();
+
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    if (cSize[axis] <= 0)
+      continue;
+
+    Bin bins[binCount];
+    const auto scale = binCount / cSize[axis];
+
+    for (int i = 0; i < count; ++i)
+    {
+      const auto id = ids[i];
+      auto b = int((_centroids[id][axis] - cMin[axis]) * scale);
+      auto& bin = bins[std::min(b, binCount - 1)];
+
+      bin.bounds.inflate(_primitiveBounds[id]);
+      ++bin.count;
+    }
+
+    // Sweep from the right to accumulate the areas of the right sides.
+    // Empty bins are skipped, since inflating a box with an empty one
+    // would make it infinite
+    float rightArea[binCount - 1];
+    int rightCount[binCount - 1];
+    Bounds3f acc;
+    int accCount = 0;
+
+    for (int i = binCount - 1; i > 0; --i)
+    {
+      if (bins[i].count)
+      {
+        acc.inflate(bins[i].bounds);
+        accCount += bins[i].count;
+      }
+      rightArea[i - 1] = accCount ? acc.area() : 0;
+      rightCount[i - 1] = accCount;
+    }
+    acc.setEmpty();
+    accCount = 0;
+    for (int i = 0; i < binCount - 1; ++i)
+    {
+      if (bins[i].count)
+      {
+        acc.inflate(bins[i].bounds);
+        accCount += bins[i].count;
+      }
+
+      auto cost = (accCount ? acc.area() * accCount : 0) +
+        rightArea[i] * rightCount[i];
+
+      if (cost < bestCost)
+      {
+        bestCost = cost;
+        bestAxis = axis;
+        bestSplit = i;
+      }
+    }
+  }
+
+  // Compare the cost of splitting against the cost of a leaf, both
+  // relative to the area of the node bounds
+  const auto leafCost = float(count);
+
+  bestCost = traversalCost + bestCost / bounds.area();
+  if (bestAxis < 0 || (bestCost >= leafCost && count <= BVHBase::maxLeafSize))
+    return makeLeaf(node, first, count);
+
+  const auto scale = binCount / cSize[bestAxis];
+  auto mid = std::partition(ids, ids + count, [&](int id)
+  {
+    auto b = int((_centroids[id][bestAxis] - cMin[bestAxis]) * scale);
+    return std::min(b, binCount - 1) <= bestSplit;
+  });
+  auto leftCount = int(mid - ids);
+
+  // Bin boundaries never leave a side empty, since the best split has
+  // a finite cost; guard against degenerate float roundoff anyway
+  if (leftCount == 0 || leftCount == count)
+    leftCount = count / 2;
+
+  auto left = int(_nodes.size());
+
+  _nodes.emplace_back();
+  makeNode(left, first, leftCount, depth + 1);
+
+  auto right = int(_nodes.size());
+
+  _nodes.emplace_back();
+  makeNode(right, first + leftCount, count - leftCount, depth + 1);
+  _nodes[node].first = right;
+  _nodes[node].count = 0;
+}
+
+} // end namespace internal
+
+
+//////////////////////////////////////////////////////////
+//
+// BVHBase implementation
+// =======
+void
+BVHBase::build(const std::vector<Bounds3f>& primitiveBounds,
+  int maxPrimitivesPerNode)
+{
+  internal::BVHBuilder{primitiveBounds,
+    maxPrimitivesPerNode,
+    _nodes,
+    _primitiveIds}.build();
+}
+
+
+//////////////////////////////////////////////////////////
+//
+// BVH implementation
+// ===
+BVH::BVH(TriangleMesh& mesh, int maxTrianglesPerNode):
+  _mesh{&mesh}
+{
+  const auto& data = mesh.data();
+  std::vector<Bounds3f> triangleBounds(data.numberOfTriangles);
+
+  for (int i = 0; i < data.numberOfTriangles; ++i)
+  {
+    const auto& t = data.triangles[i];
+    auto& b = triangleBounds[i];
+
+    b.inflate(data.vertices[t.v[0]]);
+    b.inflate(data.vertices[t.v[1]]);
+    b.inflate(data.vertices[t.v[2]]);
+  }
+  build(triangleBounds, maxTrianglesPerNode);
+}
+
+bool
+BVH::intersectTriangle(const Ray& ray, int i, Hit& hit) const
+{
+  // Moller-Trumbore
+  const auto& data = _mesh->data();
+  const auto& t = data.triangles[i];
+  const auto& p0 = data.vertices[t.v[0]];
+  const auto e1 = data.vertices[t.v[1]] - p0;
+  const auto e2 = data.vertices[t.v[2]] - p0;
+  const auto p = ray.direction.cross(e2);
+  const auto d = e1.dot(p);
+
+  if (math::isZero(d))
+    return false;
+
+  const auto invD = math::inverse(d);
+  const auto s = ray.origin - p0;
+  const auto b1 = s.dot(p) * invD;
+
+  if (b1 < 0 || b1 > 1)
+    return false;
+
+  const auto q = s.cross(e1);
+  const auto b2 = ray.direction.dot(q) * invD;
+
+  if (b2 < 0 || b1 + b2 > 1)
+    return false;
+
+  const auto distance = e2.dot(q) * invD;
+
+  if (distance < ray.tMin || distance > ray.tMax)
+    return false;
+  hit.triangleIndex = i;
+  hit.p.set(1 - b1 - b2, b1, b2);
+  hit.distance = distance;
+  return true;
+}
+
+bool
+BVH::intersect(const Ray& ray, Hit& hit) const
+{
+  auto r = ray;
+  bool found = false;
+
+  traverse(ray, [&](int i, float& tMax)
+  {
+    r.tMax = tMax;
+    if (intersectTriangle(r, i, hit))
+    {
+      tMax = hit.distance;
+      found = true;
+    }
+    return false;
+  });
+  return found;
+}
+
+bool
+BVH::intersect(const Ray& ray) const
+{
+  Hit hit;
+
+  return traverse(ray, [&](int i, float&)
+  {
+    return intersectTriangle(ray, i, hit);
+  });
+}
+
+} // end namespace cg
@@ -31,38 +31,20 @@
 // Last revision: 26/10/2018
 
 #include "graphics/GLGraphicsBase.h"
+#include <cstddef>
+#include <cstring>
 
 namespace cg
 { // begin namespace cg
 
-static const char* pointVertexShader =
+static const char* vertexShader =
   "#version 400\n"
-  "uniform vec4 p;\n"
-  "uniform vec4 pointColor;\n"
+  "layout(location = 0) in vec4 position;\n"
+  "layout(location = 1) in vec4 vertexColor;\n"
   "out vec4 color;\n"
   "void main() {\n"
-  "gl_Position = p;\n"
-  "color = pointColor;\n"
-  "}";
-
-static const char* lineVertexShader =
-  "#version 400\n"
-  "uniform vec4 p[2];\n"
-  "uniform vec4 vertexColors[2];\n"
-  "out vec4 color;\n"
-  "void main() {\n"
-  "gl_Position = p[gl_VertexID];\n"
-  "color = vertexColors[gl_VertexID];\n"
-  "}";
-
-static const char* triangleVertexShader =
-  "#version 400\n"
-  "uniform vec4 p[3];\n"
-  "uniform vec4 vertexColors[3];\n"
-  "out vec4 color;\n"
-  "void main() {\n"
-  "gl_Position = p[gl_VertexID];\n"
-  "color = vertexColors[gl_VertexID];\n"
+  "gl_Position = position;\n"
+  "color = vertexColor;\n"
   "}";
 
 static const char* fragmentShader =
@@ -73,26 +55,27 @@ static const char* fragmentShader =
   "fragmentColor = color;\n"
   "}";
 
+// Initial size of the vertex ring buffer, in bytes
+static const GLsizeiptr bufferSize = 1 << 20;
+
 GLGraphicsBase::GLGraphicsBase():
-  _pointDrawer{"Point Drawer"},
-  _lineDrawer{"Line Drawer"},
-  _triangleDrawer{"Triangle Drawer"}
+  _drawer{"Immediate Drawer"}
 {
-  using namespace GLSL;
-
-  _pointDrawer.setShaders(pointVertexShader, fragmentShader);
-  _pointDrawer.use();
-  _pointLoc = _pointDrawer.uniformLocation("p");
-  _pointColorLoc = _pointDrawer.uniformLocation("pointColor");
-  _lineDrawer.setShaders(lineVertexShader, fragmentShader);
-  _lineDrawer.use();
-  _linePointsLoc = _lineDrawer.uniformLocation("p[0]");
-  _lineColorsLoc = _lineDrawer.uniformLocation("vertexColors[0]");
-  _triangleDrawer.setShaders(triangleVertexShader, fragmentShader);
-  _triangleDrawer.use();
-  _trianglePointsLoc = _triangleDrawer.uniformLocation("p[0]");
-  _triangleColorsLoc = _triangleDrawer.uniformLocation("vertexColors[0]");
+  _drawer.setShaders(vertexShader, fragmentShader);
   glGenVertexArrays(1, &_vao);
+  glGenBuffers(1, &_buffer);
+  glBindVertexArray(_vao);
+  glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+  glBufferData(GL_ARRAY_BUFFER, _bufferSize = bufferSize, 0, GL_STREAM_DRAW);
+  glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), 0);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(1,
+    4,
+    GL_FLOAT,
+    GL_FALSE,
+    sizeof(Vertex),
+    (const void*)offsetof(Vertex, color));
+  glEnableVertexAttribArray(1);
   setPointSize(4);
   setPointColor(Color::red);
   setLineWidth(1);
@@ -102,54 +85,113 @@ GLGraphicsBase::GLGraphicsBase():
 
 GLGraphicsBase::~GLGraphicsBase()
 {
+  glDeleteBuffers(1, &_buffer);
   glDeleteVertexArrays(1, &_vao);
 }
 
+inline void
+GLGraphicsBase::Batch::add(const vec4f* points,
+  const Color* colors,
+  int n,
+  float size)
+{
+  const auto first = int(vertices.size());
+
+  for (int i = 0; i < n; ++i)
+    vertices.push_back({points[i], colors[i]});
+  if (runs.empty() || runs.back().size != size)
+    runs.push_back({first, n, size});
+  else
+    runs.back().count += n;
+}
+
 void
 GLGraphicsBase::drawPoint(const vec4f* point)
 {
-  using namespace GLSL;
-
-  auto cp = Program::current();
-
-  _pointDrawer.use();
-  _pointDrawer.setUniformVec4(_pointColorLoc, _pointColor);
-  glUniform4fv(_pointLoc, 1, (float*)point);
-  glBindVertexArray(_vao);
-  glPointSize(_pointSize);
-  glDrawArrays(GL_POINTS, 0, 1);
-  Program::setCurrent(cp);
+  _points.add(point, &_pointColor, 1, _pointSize);
 }
 
 void
 GLGraphicsBase::drawLine(const vec4f* points)
 {
-  using namespace GLSL;
+  _lines.add(points, _lineColors, 2, _lineWidth);
+}
 
-  auto cp = Program::current();
+void
+GLGraphicsBase::drawTriangle(const vec4f* points)
+{
+  _triangles.add(points, _triangleColors, 3, 0);
+}
 
-  _lineDrawer.use();
-  glUniform4fv(_lineColorsLoc, 2, (float*)_lineColors);
-  glUniform4fv(_linePointsLoc, 2, (float*)points);
-  glBindVertexArray(_vao);
-  glLineWidth(_lineWidth);
-  glDrawArrays(GL_LINES, 0, 2);
-  Program::setCurrent(cp);
+inline void
+GLGraphicsBase::draw(const Batch& batch, GLenum mode, GLint first)
+{
+  for (const auto& run : batch.runs)
+  {
+    if (mode == GL_POINTS)
+      glPointSize(run.size);
+    else if (mode == GL_LINES)
+      glLineWidth(run.size);
+    glDrawArrays(mode, first + run.first, run.count);
+  }
 }
 
 void
-GLGraphicsBase::drawTriangle(const vec4f* points)
+GLGraphicsBase::flush()
 {
   using namespace GLSL;
 
+  const Batch* batches[]{&_triangles, &_lines, &_points};
+  GLsizeiptr size{};
+
+  for (auto batch : batches)
+    size += batch->vertices.size() * sizeof(Vertex);
+  if (size == 0)
+    return;
+  glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+  // Write after the data of the previous flushes, which may still be
+  // in use by the GPU, or orphan the buffer if there is no room left
+  if (_bufferHead + size > _bufferSize)
+  {
+    while (size > _bufferSize)
+      _bufferSize *= 2;
+    glBufferData(GL_ARRAY_BUFFER, _bufferSize, 0, GL_STREAM_DRAW);
+    _bufferHead = 0;
+  }
+
+  auto p = (char*)glMapBufferRange(GL_ARRAY_BUFFER,
+    _bufferHead,
+    size,
+    GL_MAP_WRITE_BIT |
+    GL_MAP_INVALIDATE_RANGE_BIT |
+    GL_MAP_UNSYNCHRONIZED_BIT);
+
+  for (auto batch : batches)
+  {
+    auto s = batch->vertices.size() * sizeof(Vertex);
+
+    memcpy(p, batch->vertices.data(), s);
+    p += s;
+  }
+  glUnmapBuffer(GL_ARRAY_BUFFER);
+
   auto cp = Program::current();
+  auto first = GLint(_bufferHead / sizeof(Vertex));
 
-  _triangleDrawer.use();
+  _drawer.use();
   glBindVertexArray(_vao);
-  glUniform4fv(_triangleColorsLoc, 3, (float*)_triangleColors);
-  glUniform4fv(_trianglePointsLoc, 3, (float*)points);
-  glDrawArrays(GL_TRIANGLES, 0, 3);
+  draw(_triangles, GL_TRIANGLES, first);
+  first += GLint(_triangles.vertices.size());
+  draw(_lines, GL_LINES, first);
+  first += GLint(_lines.vertices.size());
+  draw(_points, GL_POINTS, first);
   Program::setCurrent(cp);
+  _bufferHead += size;
+  for (auto batch : {&_triangles, &_lines, &_points})
+  {
+    batch->vertices.clear();
+    batch->runs.clear();
+  }
 }
 
 } // end namespace cg
@@ -349,13 +349,79 @@ Program::uniformLocation(const char* s) const
 {
   checkInUse();
 
+  std::string key{s};
+  auto it = _uniforms.find(key);
+
+  if (it != _uniforms.end())
+    return it->second;
+
+  // Names not loaded at link time, e.g., of array elements other
+  // than the first one
   auto loc = glGetUniformLocation(_handle, s);
 
   if (loc == -1)
     error(VARIABLE_NOT_FOUND, name(), s);
+  _uniforms.emplace(std::move(key), loc);
   return loc;
 }
 
+GLuint
+Program::uniformBlockIndex(const char* s) const
+{
+  auto index = glGetUniformBlockIndex(_handle, s);
+
+  if (index == GL_INVALID_INDEX)
+    error(VARIABLE_NOT_FOUND, name(), s);
+  return index;
+}
+
+void
+Program::setUniformBlockBinding(const char* s, GLuint binding)
+{
+  if (_state == State::MODIFIED)
+    link();
+  glUniformBlockBinding(_handle, uniformBlockIndex(s), binding);
+}
+
+void
+Program::loadUniforms()
+{
+  GLint count;
+  GLint maxLength;
+
+  _uniforms.clear();
+  glGetProgramiv(_handle, GL_ACTIVE_UNIFORMS, &count);
+  glGetProgramiv(_handle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+  std::string buffer(maxLength, '\0');
+
+  for (GLint i = 0; i < count; ++i)
+  {
+    GLsizei length;
+    GLint size;
+    GLenum type;
+
+    glGetActiveUniform(_handle,
+      i,
+      maxLength,
+      &length,
+      &size,
+      &type,
+      &buffer[0]);
+
+    std::string s{buffer.c_str(), size_t(length)};
+    auto loc = glGetUniformLocation(_handle, s.c_str());
+
+    // Members of uniform blocks have no location
+    if (loc == -1)
+      continue;
+    // Arrays are reported as "a[0]", and can also be named "a"
+    if (s.size() > 3 && s.compare(s.size() - 3, 3, "[0]") == 0)
+      _uniforms.emplace(s.substr(0, s.size() - 3), loc);
+    _uniforms.emplace(std::move(s), loc);
+  }
+}
+
 GLuint
 Program::subroutineIndex(GLenum shader, const char* s) const
 {
@@ -379,7 +445,10 @@ Program::link()
   // Get link status
   glGetProgramiv(_handle, GL_LINK_STATUS, &ok);
   if (ok == GL_TRUE)
+  {
     _state = State::BUILT;
+    loadUniforms();
+  }
   else
   {
     auto log = infoLog(_handle, glGetProgramiv, glGetProgramInfoLog);
@@ -0,0 +1,241 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: Image.cpp
+// ========
+// Source file for RGB image.
+//
+// Author: Paulo Pagliosa
+// Last revision: 17/10/2026
+
+#include "graphics/Image.h"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+
+namespace cg
+{ // begin namespace cg
+
+namespace internal
+{ // begin namespace internal
+
+inline unsigned char
+toByte(float c)
+{
+  return c <= 0 ? 0 : c >= 1 ? 255 : (unsigned char)(c * 255 + 0.5f);
+}
+
+class PNGWriter
+{
+public:
+  PNGWriter(std::ostream& file):
+    _file{&file}
+  {
+    // do nothing
+  }
+
+  bool write(const unsigned char* rgb, int w, int h);
+
+private:
+  std::ostream* _file;
+  std::vector<unsigned char> _chunk;
+
+  static uint32_t crc(const unsigned char*, size_t);
+
+  void put8(uint32_t x)
+  {
+    _chunk.push_back((unsigned char)x);
+  }
+
+  void put16LE(uint32_t x)
+  {
+    put8(x);
+    put8(x >> 8);
+  }
+
+  void put32(uint32_t x)
+  {
+    put8(x >> 24);
+    put8(x >> 16);
+    put8(x >> 8);
+    put8(x);
+  }
+
+  void beginChunk(const char* type);
+  bool endChunk();
+
+}; // PNGWriter
+
+uint32_t
+PNGWriter::crc(const unsigned char* data, size_t size)
+{
+  static uint32_t table[256];
+
+  if (table[1] == 0)
+    for (uint32_t n = 0; n < 256; ++n)
+    {
+      auto c = n;
+
+      for (int k = 0; k < 8; ++k)
+        c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+      table[n] = c;
+    }
+
+  uint32_t c = 0xffffffffu;
+
+  for (size_t i = 0; i < size; ++i)
+    c = table[(c ^ data[i]) & 0xff] ^ (c >> 8);
+  return c ^ 0xffffffffu;
+}
+
+inline void
+PNGWriter::beginChunk(const char* type)
+{
+  // Leave room for the length, which is not covered by the CRC
+  _chunk.assign(4, 0);
+  _chunk.insert(_chunk.end(), type, type + 4);
+}
+
+bool
+PNGWriter::endChunk()
+{
+  auto size = uint32_t(_chunk.size() - 8);
+
+  put32(crc(_chunk.data() + 4, _chunk.size() - 4));
+  _chunk[0] = (unsigned char)(size >> 24);
+  _chunk[1] = (unsigned char)(size >> 16);
+  _chunk[2] = (unsigned char)(size >> 8);
+  _chunk[3] = (unsigned char)size;
+  return bool(_file->write((const char*)_chunk.data(), _chunk.size()));
+}
+
+bool
+PNGWriter::write(const unsigned char* rgb, int w, int h)
+{
+  static const unsigned char signature[]{137, 80, 78, 71, 13, 10, 26, 10};
+
+  if (!_file->write((const char*)signature, sizeof signature))
+    return false;
+  beginChunk("IHDR");
+  put32(w);
+  put32(h);
+  put8(8); // bit depth
+  put8(2); // color type: RGB
+  put8(0); // compression
+  put8(0); // filter
+  put8(0); // interlace
+  if (!endChunk())
+    return false;
+
+  // The zlib stream is made of stored deflate blocks, one scanline (a
+  // filter type byte followed by the RGB bytes) at a time, so that no
+  // compression library is needed
+  const auto rowSize = size_t(w) * 3;
+  uint32_t s1 = 1, s2 = 0; // Adler-32
+
+  beginChunk("IDAT");
+  put8(0x78);
+  put8(0x01);
+  for (int y = 0; y < h; ++y)
+  {
+    auto row = rgb + rowSize * y;
+
+    // A row longer than 65534 bytes is split into several blocks
+    for (size_t i = 0, n; i <= rowSize; i += n)
+    {
+      n = std::min(rowSize + 1 - i, size_t(0xffff));
+      put8(y == h - 1 && i + n > rowSize);
+      put16LE(uint32_t(n));
+      put16LE(~uint32_t(n));
+      for (size_t k = i; k < i + n; ++k)
+      {
+        auto b = k == 0 ? 0 : row[k - 1];
+
+        put8(b);
+        s1 = (s1 + b) % 65521;
+        s2 = (s2 + s1) % 65521;
+      }
+    }
+  }
+  put32(s2 << 16 | s1);
+  if (!endChunk())
+    return false;
+  beginChunk("IEND");
+  return endChunk();
+}
+
+} // end namespace internal
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// Image implementation
+// =====
+std::vector<unsigned char>
+Image::rgb() const
+{
+  std::vector<unsigned char> rgb(size_t(_width) * _height * 3);
+  auto p = rgb.data();
+
+  for (int y = _height; y-- > 0;)
+    for (int x = 0; x < _width; ++x)
+    {
+      const auto& c = operator ()(x, y);
+
+      *p++ = internal::toByte(c.r);
+      *p++ = internal::toByte(c.g);
+      *p++ = internal::toByte(c.b);
+    }
+  return rgb;
+}
+
+bool
+Image::writePPM(const char* filename) const
+{
+  std::ofstream file{filename, std::ios::binary};
+
+  if (!file)
+    return false;
+
+  auto rgb = this->rgb();
+
+  file << "P6\n" << _width << ' ' << _height << "\n255\n";
+  file.write((const char*)rgb.data(), rgb.size());
+  file.close();
+  return bool(file);
+}
+
+bool
+Image::writePNG(const char* filename) const
+{
+  std::ofstream file{filename, std::ios::binary};
+
+  if (!file || !internal::PNGWriter{file}.write(rgb().data(), _width, _height))
+    return false;
+  file.close();
+  return bool(file);
+}
+
+} // end namespace cg
@@ -0,0 +1,175 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: MappedFile.cpp
+// ========
+// Source file for read-only memory-mapped file.
+//
+// Author: Paulo Pagliosa
+// Last revision: 17/10/2026
+
+#include "utils/MappedFile.h"
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cg
+{ // begin namespace cg
+
+
+//////////////////////////////////////////////////////////
+//
+// MappedFile implementation
+// ==========
+#ifdef _WIN32
+
+bool
+MappedFile::open(const char* filename, bool copyOnWrite)
+{
+  close();
+
+  auto file = CreateFileA(filename,
+    GENERIC_READ,
+    FILE_SHARE_READ,
+    nullptr,
+    OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+    nullptr);
+
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+
+  LARGE_INTEGER size;
+
+  if (!GetFileSizeEx(file, &size))
+  {
+    CloseHandle(file);
+    return false;
+  }
+  _file = file;
+  _size = (size_t)size.QuadPart;
+  _open = true;
+  _copyOnWrite = copyOnWrite;
+  // Mapping an empty file is an error on Windows.
+  if (_size == 0)
+    return true;
+  _mapping = CreateFileMappingA(file,
+    nullptr,
+    copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY,
+    0,
+    0,
+    nullptr);
+  if (_mapping != nullptr)
+    _data = (char*)MapViewOfFile(_mapping,
+      copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ,
+      0,
+      0,
+      0);
+  if (_data == nullptr)
+  {
+    close();
+    return false;
+  }
+  return true;
+}
+
+void
+MappedFile::close()
+{
+  if (_data != nullptr)
+    UnmapViewOfFile(_data);
+  if (_mapping != nullptr)
+    CloseHandle(_mapping);
+  if (_file != nullptr)
+    CloseHandle(_file);
+  _data = nullptr;
+  _mapping = _file = nullptr;
+  _size = 0;
+  _open = _copyOnWrite = false;
+}
+
+#else
+
+bool
+MappedFile::open(const char* filename, bool copyOnWrite)
+{
+  close();
+
+  auto fd = ::open(filename, O_RDONLY);
+
+  if (fd == -1)
+    return false;
+
+  struct stat s;
+
+  if (fstat(fd, &s) == -1)
+  {
+    ::close(fd);
+    return false;
+  }
+  _size = (size_t)s.st_size;
+  if (_size > 0)
+  {
+    auto prot = copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+    auto data = mmap(nullptr, _size, prot, MAP_PRIVATE, fd, 0);
+
+    if (data == MAP_FAILED)
+    {
+      ::close(fd);
+      _size = 0;
+      return false;
+    }
+    madvise(data, _size, MADV_SEQUENTIAL);
+    _data = (char*)data;
+  }
+  // The mapping keeps its own reference to the file.
+  ::close(fd);
+  _open = true;
+  _copyOnWrite = copyOnWrite;
+  return true;
+}
+
+void
+MappedFile::close()
+{
+  if (_data != nullptr)
+    munmap(_data, _size);
+  _data = nullptr;
+  _size = 0;
+  _open = _copyOnWrite = false;
+}
+
+#endif // _WIN32
+
+} // end namespace cg
@@ -0,0 +1,389 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: MeshCache.cpp
+// ========
+// Source file for binary mesh cache.
+//
+// Author: Paulo Pagliosa
+// Last revision: 17/10/2026
+
+#include "utils/MeshCache.h"
+#include "utils/MappedFile.h"
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace cg
+{ // begin namespace cg
+
+namespace internal
+{ // begin namespace internal
+
+namespace fs = std::filesystem;
+
+// Alignment of the header and of the arrays in a cache file.
+constexpr size_t cacheAlignment = 64;
+
+// Level of detail of a cached mesh; the level 0 is the mesh itself
+struct MeshCacheLevel
+{
+  int32_t numberOfVertices;
+  int32_t numberOfTriangles;
+  float error;
+  float bounds[6];
+  uint64_t verticesOffset;
+  uint64_t vertexNormalsOffset;
+  uint64_t trianglesOffset;
+
+}; // MeshCacheLevel
+
+struct MeshCacheHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t headerSize;
+  uint64_t fileSize;
+  uint64_t sourceSize;
+  int64_t sourceTime;
+  uint64_t sourceHash;
+  uint32_t levelCount;
+  uint32_t levelSize;
+
+}; // MeshCacheHeader
+
+// The header is followed by the levels, at most maxCacheLevels
+constexpr uint32_t maxCacheLevels = 32;
+
+static const char cacheMagic[8]{'C', 'G', 'M', 'E', 'S', 'H', '\r', '\n'};
+
+inline size_t
+align(size_t offset)
+{
+  return (offset + cacheAlignment - 1) & ~(cacheAlignment - 1);
+}
+
+uint64_t
+hash(const char* s, size_t size)
+{
+  const uint64_t m{0x9e3779b97f4a7c15};
+  auto h = 0xcbf29ce484222325 ^ size;
+  size_t i{};
+
+  for (uint64_t k; i + 8 <= size; i += 8)
+  {
+    memcpy(&k, s + i, 8);
+    h = (h ^ k) * m;
+    h ^= h >> 29;
+  }
+  for (; i < size; ++i)
+    h = (h ^ uint8_t(s[i])) * 0x100000001b3;
+  return h;
+}
+
+struct SourceInfo
+{
+  uint64_t size;
+  int64_t time;
+
+  bool get(const char* filename)
+  {
+    std::error_code ec;
+
+    size = fs::file_size(filename, ec);
+    if (ec)
+      return false;
+    time = fs::last_write_time(filename, ec).time_since_epoch().count();
+    return !ec;
+  }
+
+}; // SourceInfo
+
+bool
+hashFile(const char* filename, uint64_t& h)
+{
+  MappedFile file;
+
+  if (!file.open(filename))
+    return false;
+  h = hash(file.data(), file.size());
+  return true;
+}
+
+bool
+isValid(const MeshCacheHeader& h, size_t size)
+{
+  if (size < sizeof h || memcmp(h.magic, cacheMagic, sizeof cacheMagic))
+    return false;
+  if (h.version != MeshCache::version || h.headerSize != sizeof h)
+    return false;
+  return h.fileSize == size
+    && h.levelSize == sizeof(MeshCacheLevel)
+    && h.levelCount > 0
+    && h.levelCount <= maxCacheLevels
+    && sizeof h + h.levelCount * sizeof(MeshCacheLevel) <= size;
+}
+
+bool
+isValid(const MeshCacheLevel& l, size_t size)
+{
+  if (l.numberOfVertices < 0 || l.numberOfTriangles < 0)
+    return false;
+
+  auto inside = [size](uint64_t offset, uint64_t length)
+  {
+    return offset % cacheAlignment == 0
+      && offset >= sizeof(MeshCacheHeader)
+      && offset <= size
+      && length <= size - offset;
+  };
+  const auto nv = uint64_t(l.numberOfVertices);
+  const auto nt = uint64_t(l.numberOfTriangles);
+
+  return inside(l.verticesOffset, nv * sizeof(vec3f))
+    && inside(l.vertexNormalsOffset, nv * sizeof(vec3f))
+    && inside(l.trianglesOffset, nt * sizeof(TriangleMesh::Triangle));
+}
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// MappedMeshStorage: storage of a mesh built over a mapped cache
+// =================
+class MappedMeshStorage: public SharedObject
+{
+public:
+  MappedFile file;
+
+}; // MappedMeshStorage
+
+} // end namespace internal
+
+
+//////////////////////////////////////////////////////////
+//
+// MeshCache implementation
+// =========
+TriangleMesh*
+MeshCache::read(const char* filename, const char* sourceFilename)
+{
+  using namespace internal;
+
+  SourceInfo source;
+  MeshCacheHeader header;
+  std::error_code ec;
+
+  if (!source.get(sourceFilename))
+    return nullptr;
+  {
+    std::ifstream in{filename, std::ios::in | std::ios::binary};
+
+    if (!in.read((char*)&header, sizeof header))
+      return nullptr;
+  }
+
+  auto size = fs::file_size(filename, ec);
+
+  if (ec || !isValid(header, size) || header.sourceSize != source.size)
+    return nullptr;
+  if (header.sourceTime != source.time)
+  {
+    uint64_t h;
+
+    if (!hashFile(sourceFilename, h) || h != header.sourceHash)
+      return nullptr;
+
+    // The source was touched but not changed: record its new time
+    // in order to skip hashing it the next time.
+    std::fstream out{filename, std::ios::in | std::ios::out | std::ios::binary};
+
+    out.seekp(offsetof(MeshCacheHeader, sourceTime));
+    out.write((const char*)&source.time, sizeof source.time);
+  }
+
+  Reference<MappedMeshStorage> storage{new MappedMeshStorage};
+  auto& file = storage->file;
+
+  // The pages are mapped copy-on-write since a mesh can be modified,
+  // e.g., by TriangleMesh::TRS().
+  if (!file.open(filename, true) || file.size() != size)
+    return nullptr;
+
+  auto base = file.writableData();
+  auto levels = (const MeshCacheLevel*)(base + sizeof header);
+
+  for (uint32_t i = 0; i < header.levelCount; ++i)
+    if (!isValid(levels[i], size))
+      return nullptr;
+
+  // The levels of detail share the mapped pages of the mesh
+  TriangleMesh* mesh{};
+  TriangleMesh* last{};
+
+  for (uint32_t i = 0; i < header.levelCount; ++i)
+  {
+    const auto& level = levels[i];
+    TriangleMesh::Data data;
+
+    data.numberOfVertices = level.numberOfVertices;
+    data.vertices = (vec3f*)(base + level.verticesOffset);
+    data.vertexNormals = (vec3f*)(base + level.vertexNormalsOffset);
+    data.numberOfTriangles = level.numberOfTriangles;
+    data.triangles = (TriangleMesh::Triangle*)(base + level.trianglesOffset);
+
+    Bounds3f bounds;
+    const auto b = level.bounds;
+
+    if (data.numberOfVertices > 0)
+      bounds.set({b[0], b[1], b[2]}, {b[3], b[4], b[5]});
+
+    auto m = new TriangleMesh{data, bounds, storage};
+
+    m->lodError = level.error;
+    if (last == nullptr)
+      mesh = m;
+    else
+      last->lod = m;
+    last = m;
+  }
+  return mesh;
+}
+
+bool
+MeshCache::write(const char* filename,
+  const char* sourceFilename,
+  const TriangleMesh& mesh)
+{
+  using namespace internal;
+
+  SourceInfo source;
+  MeshCacheHeader header{};
+
+  if (!source.get(sourceFilename)
+    || !hashFile(sourceFilename, header.sourceHash))
+    return false;
+
+  std::vector<const TriangleMesh*> meshes;
+
+  for (auto m = &mesh; m != nullptr; m = m->lod)
+  {
+    if (!m->hasVertexNormals() || meshes.size() == maxCacheLevels)
+      return false;
+    meshes.push_back(m);
+  }
+
+  const auto n = uint32_t(meshes.size());
+  std::vector<MeshCacheLevel> levels(n);
+  auto offset = align(sizeof header + n * sizeof(MeshCacheLevel));
+
+  for (uint32_t i = 0; i < n; ++i)
+  {
+    const auto& data = meshes[i]->data();
+    const auto vs = data.numberOfVertices * sizeof(vec3f);
+    const auto ts = data.numberOfTriangles * sizeof(TriangleMesh::Triangle);
+    const auto bounds = meshes[i]->bounds();
+    auto& level = levels[i];
+
+    level.numberOfVertices = data.numberOfVertices;
+    level.numberOfTriangles = data.numberOfTriangles;
+    level.error = meshes[i]->lodError;
+    memcpy(level.bounds, &bounds.min(), sizeof(vec3f));
+    memcpy(level.bounds + 3, &bounds.max(), sizeof(vec3f));
+    level.verticesOffset = offset;
+    level.vertexNormalsOffset = align(level.verticesOffset + vs);
+    level.trianglesOffset = align(level.vertexNormalsOffset + vs);
+    offset = align(level.trianglesOffset + ts);
+  }
+  memcpy(header.magic, cacheMagic, sizeof cacheMagic);
+  header.version = version;
+  header.headerSize = sizeof header;
+  header.sourceSize = source.size;
+  header.sourceTime = source.time;
+  header.levelCount = n;
+  header.levelSize = sizeof(MeshCacheLevel);
+
+  {
+    const auto& last = meshes.back()->data();
+
+    header.fileSize = levels.back().trianglesOffset +
+      last.numberOfTriangles * sizeof(TriangleMesh::Triangle);
+  }
+
+  std::error_code ec;
+  fs::path path{filename};
+
+  if (path.has_parent_path())
+    fs::create_directories(path.parent_path(), ec);
+
+  // Write a temporary file first, so that a partially written cache
+  // is never taken as valid.
+  auto temp = path;
+
+  temp += ".tmp";
+  {
+    std::ofstream out{temp, std::ios::out | std::ios::binary | std::ios::trunc};
+    const char zeros[cacheAlignment]{};
+    uint64_t offset{};
+
+    auto put = [&](uint64_t at, const void* p, size_t size)
+    {
+      out.write(zeros, at - offset);
+      out.write((const char*)p, size);
+      offset = at + size;
+    };
+
+    put(0, &header, sizeof header);
+    put(sizeof header, levels.data(), n * sizeof(MeshCacheLevel));
+    for (uint32_t i = 0; i < n; ++i)
+    {
+      const auto& data = meshes[i]->data();
+      const auto vs = data.numberOfVertices * sizeof(vec3f);
+      const auto& level = levels[i];
+
+      put(level.verticesOffset, data.vertices, vs);
+      put(level.vertexNormalsOffset, data.vertexNormals, vs);
+      put(level.trianglesOffset,
+        data.triangles,
+        data.numberOfTriangles * sizeof(TriangleMesh::Triangle));
+    }
+    if (!out)
+    {
+      out.close();
+      fs::remove(temp, ec);
+      return false;
+    }
+  }
+  fs::rename(temp, path, ec);
+  if (ec)
+  {
+    fs::remove(temp, ec);
+    return false;
+  }
+  return true;
+}
+
+} // end namespace cg
@@ -0,0 +1,342 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: MeshOptimizer.cpp
+// ========
+// Source file for mesh optimizer.
+//
+// Author: Paulo Pagliosa
+// Last revision: 17/10/2026
+
+#include "geometry/MeshOptimizer.h"
+#include <algorithm>
+#include <vector>
+
+namespace cg
+{ // begin namespace cg
+
+
+//////////////////////////////////////////////////////////
+//
+// MeshOptimizer implementation
+// =============
+MeshOptimizer::Stats
+MeshOptimizer::analyze(const TriangleMesh::Data& data, int cacheSize)
+{
+  const auto nv = data.numberOfVertices;
+  const auto nt = data.numberOfTriangles;
+  // The cache holds the time each vertex entered it
+  std::vector<int> time(nv, -cacheSize - 1);
+  std::vector<char> used(nv);
+  int misses = 0;
+  int vertexCount = 0;
+
+  for (int i = 0; i < nt; ++i)
+    for (auto v : data.triangles[i].v)
+    {
+      if (misses - time[v] > cacheSize)
+        time[v] = misses++;
+      if (!used[v])
+        used[v] = 1, ++vertexCount;
+    }
+  if (nt == 0)
+    return {0, 0};
+  return {float(misses) / nt, float(misses) / vertexCount};
+}
+
+void
+MeshOptimizer::optimizeVertexCache(TriangleMesh::Data& data,
+  int cacheSize,
+  std::vector<int>* clusters)
+{
+  const auto nv = data.numberOfVertices;
+  const auto nt = data.numberOfTriangles;
+
+  if (clusters != nullptr)
+    clusters->clear();
+  if (nt == 0)
+    return;
+
+  auto triangles = data.triangles;
+  // Triangles of each vertex, in compressed rows
+  std::vector<int> first(nv + 1);
+  std::vector<int> adjacency(3 * nt);
+
+  for (int i = 0; i < nt; ++i)
+    for (auto v : triangles[i].v)
+      ++first[v + 1];
+  for (int v = 0; v < nv; ++v)
+    first[v + 1] += first[v];
+  {
+    std::vector<int> next(first.begin(), first.end() - 1);
+
+    for (int i = 0; i < nt; ++i)
+      for (auto v : triangles[i].v)
+        adjacency[next[v]++] = i;
+  }
+
+  // Number of triangles not yet emitted of each vertex
+  std::vector<int> live(nv);
+
+  for (int v = 0; v < nv; ++v)
+    live[v] = first[v + 1] - first[v];
+
+  std::vector<int> time(nv);
+  std::vector<char> emitted(nt);
+  std::vector<int> deadEnd;
+  std::vector<int> candidates;
+  std::vector<TriangleMesh::Triangle> output;
+  int stamp = cacheSize + 1;
+  int cursor = 1;
+  int fan = 0;
+
+  deadEnd.reserve(3 * nt);
+  output.reserve(nt);
+  if (clusters != nullptr)
+    clusters->push_back(0);
+  while (fan >= 0)
+  {
+    // Emit the triangles of the fanning vertex not yet emitted
+    candidates.clear();
+    for (int k = first[fan]; k < first[fan + 1]; ++k)
+    {
+      auto t = adjacency[k];
+
+      if (emitted[t])
+        continue;
+      emitted[t] = 1;
+      output.push_back(triangles[t]);
+      for (auto v : triangles[t].v)
+      {
+        deadEnd.push_back(v);
+        candidates.push_back(v);
+        --live[v];
+        if (stamp - time[v] > cacheSize)
+          time[v] = stamp++;
+      }
+    }
+
+    // The next fanning vertex is the candidate which is in the cache
+    // the longest and will still be there after its triangles are
+    // emitted, if any
+    fan = -1;
+
+    int best = -1;
+
+    for (auto v : candidates)
+    {
+      if (live[v] == 0)
+        continue;
+
+      int priority = 0;
+
+      if (stamp - time[v] + 2 * live[v] <= cacheSize)
+        priority = stamp - time[v];
+      if (priority > best)
+      {
+        best = priority;
+        fan = v;
+      }
+    }
+    if (fan >= 0)
+      continue;
+    // Dead end: restart from a recently referenced vertex, if any, or
+    // else from the next vertex with triangles left. The triangles
+    // emitted so far end a cluster
+    if (clusters != nullptr && clusters->back() < int(output.size()))
+      clusters->push_back(int(output.size()));
+    while (!deadEnd.empty())
+    {
+      auto v = deadEnd.back();
+
+      deadEnd.pop_back();
+      if (live[v] > 0)
+      {
+        fan = v;
+        break;
+      }
+    }
+    if (fan >= 0)
+      continue;
+    for (; cursor < nv; ++cursor)
+      if (live[cursor] > 0)
+      {
+        fan = cursor++;
+        break;
+      }
+  }
+  std::copy(output.begin(), output.end(), triangles);
+  if (clusters != nullptr && clusters->back() == nt)
+    clusters->pop_back();
+}
+
+void
+MeshOptimizer::optimizeOverdraw(TriangleMesh::Data& data,
+  const std::vector<int>& clusters,
+  float threshold,
+  int cacheSize)
+{
+  const auto nt = data.numberOfTriangles;
+  auto triangles = data.triangles;
+  auto vertices = data.vertices;
+  // Split the clusters further where the cache miss ratio since the
+  // start of the piece falls below threshold times the ratio of the
+  // whole cluster, so that flushing the cache at the new seam costs
+  // little (Sander et al.)
+  std::vector<int> starts;
+  std::vector<int> time(data.numberOfVertices);
+  int stamp = 0;
+  auto simulate = [&](int i)
+  {
+    int misses = 0;
+
+    for (auto v : triangles[i].v)
+      if (stamp - time[v] > cacheSize)
+        time[v] = stamp++, ++misses;
+    return misses;
+  };
+
+  for (int c = 0, n = int(clusters.size()); c < n; ++c)
+  {
+    auto first = clusters[c];
+    auto e = c + 1 < n ? clusters[c + 1] : nt;
+    int misses = 0;
+
+    stamp += cacheSize + 1;
+    for (int i = first; i < e; ++i)
+      misses += simulate(i);
+
+    auto limit = threshold * misses / (e - first);
+
+    starts.push_back(first);
+    stamp += cacheSize + 1;
+    misses = 0;
+    for (int i = first; i < e; ++i)
+    {
+      misses += simulate(i);
+      if (i + 1 < e && misses < limit * (i + 1 - first))
+      {
+        starts.push_back(first = i + 1);
+        misses = 0;
+        stamp += cacheSize + 1;
+      }
+    }
+  }
+
+  const auto nc = int(starts.size());
+
+  if (nc < 2)
+    return;
+
+  // Area weighted centroid and normal of each cluster, and of the mesh
+  std::vector<vec3f> centroids(nc);
+  std::vector<vec3f> normals(nc);
+  vec3f centroid{0.0f};
+  float area{0};
+
+  for (int c = 0; c < nc; ++c)
+  {
+    auto e = c + 1 < nc ? starts[c + 1] : nt;
+    vec3f p{0.0f};
+    vec3f n{0.0f};
+    float a{0};
+
+    for (int i = starts[c]; i < e; ++i)
+    {
+      const auto& p0 = vertices[triangles[i].v[0]];
+      const auto& p1 = vertices[triangles[i].v[1]];
+      const auto& p2 = vertices[triangles[i].v[2]];
+      auto N = (p1 - p0).cross(p2 - p0);
+      auto A = N.length();
+
+      p += (p0 + p1 + p2) * A;
+      n += N;
+      a += A;
+    }
+    centroid += p;
+    area += a;
+    centroids[c] = a > 0 ? p * (1 / (3 * a)) : p;
+    normals[c] = n.versor();
+  }
+  if (area > 0)
+    centroid *= 1 / (3 * area);
+
+  // Clusters facing away from the centroid of the mesh first
+  std::vector<float> keys(nc);
+  std::vector<int> order(nc);
+
+  for (int c = 0; c < nc; ++c)
+  {
+    keys[c] = (centroids[c] - centroid).dot(normals[c]);
+    order[c] = c;
+  }
+  std::stable_sort(order.begin(), order.end(), [&keys](int a, int b)
+  {
+    return keys[a] > keys[b];
+  });
+
+  std::vector<TriangleMesh::Triangle> output;
+
+  output.reserve(nt);
+  for (auto c : order)
+    output.insert(output.end(),
+      triangles + starts[c],
+      triangles + (c + 1 < nc ? starts[c + 1] : nt));
+  std::copy(output.begin(), output.end(), triangles);
+}
+
+void
+MeshOptimizer::optimizeVertexFetch(TriangleMesh::Data& data)
+{
+  const auto nv = data.numberOfVertices;
+  const auto nt = data.numberOfTriangles;
+  std::vector<int> map(nv, -1);
+  int count = 0;
+
+  for (int i = 0; i < nt; ++i)
+    for (auto& v : data.triangles[i].v)
+    {
+      if (map[v] < 0)
+        map[v] = count++;
+      v = map[v];
+    }
+  for (int v = 0; v < nv; ++v)
+    if (map[v] < 0)
+      map[v] = count++;
+
+  std::vector<vec3f> buffer(nv);
+
+  for (int v = 0; v < nv; ++v)
+    buffer[map[v]] = data.vertices[v];
+  std::copy(buffer.begin(), buffer.end(), data.vertices);
+  if (auto normals = data.vertexNormals)
+  {
+    for (int v = 0; v < nv; ++v)
+      buffer[map[v]] = normals[v];
+    std::copy(buffer.begin(), buffer.end(), normals);
+  }
+}
+
+} // end namespace cg
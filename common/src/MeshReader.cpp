@@ -31,7 +31,13 @@
 // Last revision: 15/09/2018
 
 #include "utils/MeshReader.h"
-#include <filesystem>
+#include "geometry/MeshOptimizer.h"
+#include "utils/MappedFile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
 
 namespace cg
 { // begin namespace cg
@@ -39,191 +45,404 @@ namespace cg
 namespace internal
 { // begin namespace internal
 
-void
-readMeshSize(FILE* file, TriangleMesh::Data& data)
+
+//////////////////////////////////////////////////////////
+//
+// ArrayBuffer: growable array released as new[] storage
+// ===========
+template <typename T>
+class ArrayBuffer
 {
-  const unsigned int lineSize{128};
-  int nv{};
-  int nt{};
+public:
+  ArrayBuffer() = default;
+
+  ArrayBuffer(const ArrayBuffer&) = delete;
+  ArrayBuffer& operator =(const ArrayBuffer&) = delete;
+
+  ~ArrayBuffer()
+  {
+    delete []_data;
+  }
+
+  int size() const
+  {
+    return _size;
+  }
+
+  T& operator [](int i)
+  {
+    return _data[i];
+  }
+
+  T& add()
+  {
+    if (_size == _capacity)
+      reserve(_capacity < 1024 ? 1024 : _capacity * 2);
+    return _data[_size++];
+  }
+
+  void reserve(int capacity)
+  {
+    if (capacity <= _capacity)
+      return;
+
+    auto data = new T[capacity];
 
-  for (char line[lineSize]; fscanf_s(file, "%s", line, lineSize) != EOF;)
-    switch (line[0])
+    if (_size > 0)
+      memcpy(data, _data, _size * sizeof(T));
+    delete []_data;
+    _data = data;
+    _capacity = capacity;
+  }
+
+  /// Frees the elements.
+  void clear()
+  {
+    delete []_data;
+    _data = nullptr;
+    _size = _capacity = 0;
+  }
+
+  /// Transfers the elements to an array sized exactly to fit them.
+  T* release()
+  {
+    if (_size == 0)
+    {
+      delete []_data;
+      _data = nullptr;
+      _capacity = 0;
+      return nullptr;
+    }
+    if (_size < _capacity)
     {
-      case 'v':
-        if (line[1] == '\0')
-            nv++;
-        fgets(line, lineSize, file);
-        break;
+      auto data = new T[_size];
+
+      memcpy(data, _data, _size * sizeof(T));
+      delete []_data;
+      _data = data;
+    }
+
+    auto data = _data;
+
+    _data = nullptr;
+    _size = _capacity = 0;
+    return data;
+  }
+
+private:
+  T* _data{};
+  int _size{};
+  int _capacity{};
+
+}; // ArrayBuffer
+
+inline bool
+isBlank(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
 
-      case 'f':
+inline bool
+isDigit(char c)
+{
+  return unsigned(c - '0') < 10u;
+}
+
+inline const char*
+skipBlanks(const char* s, const char* e)
+{
+  while (s < e && isBlank(*s))
+    ++s;
+  return s;
+}
+
+inline const char*
+skipLine(const char* s, const char* e)
+{
+  if (auto eol = (const char*)memchr(s, '\n', e - s))
+    return eol + 1;
+  return e;
+}
+
+bool
+parseInt(const char*& s, const char* e, int& value)
+{
+  auto p = s;
+  auto negative = false;
+
+  if (p < e && (*p == '-' || *p == '+'))
+    negative = *p++ == '-';
+  if (p == e || !isDigit(*p))
+    return false;
+
+  int i{};
+
+  while (p < e && isDigit(*p))
+    i = i * 10 + (*p++ - '0');
+  value = negative ? -i : i;
+  s = p;
+  return true;
+}
+
+bool
+parseFloat(const char*& s, const char* e, float& value)
+{
+  static const double powers[]
+  {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  auto p = s;
+  auto negative = false;
+
+  if (p < e && (*p == '-' || *p == '+'))
+    negative = *p++ == '-';
+
+  // Accumulate up to 19 significant digits in an integer mantissa and
+  // keep track of the decimal exponent; extra digits only shift it.
+  uint64_t mantissa{};
+  int digits{};
+  int exponent{};
+  auto any = false;
+
+  for (; p < e && isDigit(*p); ++p, any = true)
+    if (digits < 19)
+    {
+      mantissa = mantissa * 10 + (*p - '0');
+      digits += mantissa != 0;
+    }
+    else
+      ++exponent;
+  if (p < e && *p == '.')
+    for (++p; p < e && isDigit(*p); ++p, any = true)
+      if (digits < 19)
       {
-        int v;
-        int n;
-        int t;
-
-        fscanf_s(file, "%s", line, lineSize);
-        /* can be one of %d, %d//%d, %d/%d, %d/%d/%d %d//%d */
-        if (strstr(line, "//"))
-        {
-          /* v//n */
-          sscanf_s(line, "%d//%d", &v, &n);
-          fscanf_s(file, "%d//%d", &v, &n);
-          fscanf_s(file, "%d//%d", &v, &n);
-          nt++;
-          while (fscanf_s(file, "%d//%d", &v, &n) > 0)
-            nt++;
-        }
-        else if (sscanf_s(line, "%d/%d/%d", &v, &t, &n) == 3)
-        {
-          /* v/t/n */
-          fscanf_s(file, "%d/%d/%d", &v, &t, &n);
-          fscanf_s(file, "%d/%d/%d", &v, &t, &n);
-          nt++;
-          while (fscanf_s(file, "%d/%d/%d", &v, &t, &n) > 0)
-            nt++;
-        }
-        else if (sscanf_s(line, "%d/%d", &v, &t) == 2)
-        {
-          /* v/t */
-          fscanf_s(file, "%d/%d", &v, &t);
-          fscanf_s(file, "%d/%d", &v, &t);
-          nt++;
-          while (fscanf_s(file, "%d/%d", &v, &t) > 0)
-            nt++;
-        }
-        else
-        {
-          /* v */
-          fscanf_s(file, "%d", &v);
-          fscanf_s(file, "%d", &v);
-          nt++;
-          while (fscanf_s(file, "%d", &v) > 0)
-            nt++;
-        }
-        break;
+        mantissa = mantissa * 10 + (*p - '0');
+        digits += mantissa != 0;
+        --exponent;
       }
+  if (!any)
+    return false;
+  if (p < e && (*p == 'e' || *p == 'E'))
+  {
+    auto q = p + 1;
+    int x;
 
-      default:
-        fgets(line, lineSize, file);
+    if (parseInt(q, e, x))
+    {
+      exponent += x;
+      p = q;
     }
-  data.numberOfVertices = nv;
-  data.numberOfTriangles = nt;
+  }
+
+  auto d = double(mantissa);
+
+  if (mantissa != 0 && exponent != 0)
+  {
+    if (exponent > 0 && exponent <= 22)
+      d *= powers[exponent];
+    else if (exponent < 0 && exponent >= -22)
+      d /= powers[-exponent];
+    else
+      d *= pow(10.0, exponent);
+  }
+  value = float(negative ? -d : d);
+  s = p;
+  return true;
 }
 
-void
-readMeshData(FILE* file, TriangleMesh::Data& data)
+inline const char*
+readVertex(const char* s, const char* e, vec3f& v)
 {
-  const unsigned int lineSize{128};
-  auto vertex = data.vertices;
-  auto triangle = data.triangles;
+  for (int i = 0; i < 3; ++i)
+    if (!parseFloat(s = skipBlanks(s, e), e, v[i]))
+      v[i] = 0;
+  return s;
+}
+
+
+//////////////////////////////////////////////////////////
+//
+// MeshChunk: mesh data parsed from a newline-aligned chunk
+// =========
+struct MeshChunk
+{
+  ArrayBuffer<vec3f> vertices;
+  ArrayBuffer<TriangleMesh::Triangle> triangles;
+  // Positions (3 * triangle + vertex) of the indices that were given
+  // relative to the end of the vertex list. They were resolved against
+  // the vertices of the chunk and must be offset by the number of
+  // vertices read in the preceding chunks.
+  ArrayBuffer<int> relativeIndices;
+  int firstVertex{};
+  int firstTriangle{};
+
+}; // MeshChunk
+
+/* Each vertex reference can be one of v, v/t, v//n or v/t/n */
+const char*
+readFace(const char* s, const char* e, MeshChunk& chunk)
+{
+  auto& triangles = chunk.triangles;
+  const auto nv = chunk.vertices.size();
+  int first{};
+  int last{};
+  bool firstRelative{};
+  bool lastRelative{};
+
+  for (int count = 0;; ++count)
+  {
+    int v;
+
+    if (!parseInt(s = skipBlanks(s, e), e, v))
+      break;
+    // Skip the texture coordinate and normal indices.
+    while (s < e && !isBlank(*s) && *s != '\n')
+      ++s;
 
-  for (char line[lineSize]; fscanf_s(file, "%s", line, lineSize) != EOF;)
-    switch (line[0])
+    // Resolve 1-based or relative (negative) indices.
+    const auto relative = v < 0;
+
+    v = relative ? nv + v : v - 1;
+    if (count == 0)
     {
-      case 'v':
-      {
-        float x;
-        float y;
-        float z;
-
-        switch (line[1])
-        {
-          case '\0':
-            fscanf_s(file, "%f %f %f", &x, &y, &z);
-            vertex->set(x, y, z);
-            vertex++;
-            break;
-
-          default:
-            fgets(line, lineSize, file);
-        }
-        break;
-      }
+      first = v;
+      firstRelative = relative;
+    }
+    else if (count >= 2)
+    {
+      auto i = triangles.size() * 3;
+
+      triangles.add().setVertices(first, last, v);
+      if (firstRelative)
+        chunk.relativeIndices.add() = i;
+      if (lastRelative)
+        chunk.relativeIndices.add() = i + 1;
+      if (relative)
+        chunk.relativeIndices.add() = i + 2;
+    }
+    last = v;
+    lastRelative = relative;
+  }
+  return s;
+}
 
-      case 'f':
+void
+readMeshChunk(const char* s, const char* e, MeshChunk& chunk)
+{
+  while (s < e)
+  {
+    s = skipBlanks(s, e);
+    if (e - s > 1 && isBlank(s[1]))
+      switch (s[0])
       {
-        int v;
-        int n;
-        int t;
-
-        fscanf_s(file, "%s", line, lineSize);
-        /* Can be one of %d, %d//%d, %d/%d, %d/%d/%d %d//%d */
-        if (strstr(line, "//"))
-        {
-          /* v//n */
-          sscanf_s(line, "%d//%d", &v, &n);
-          triangle->v[0] = v - 1;
-          fscanf_s(file, "%d//%d", &v, &n);
-          triangle->v[1] = v - 1;
-          fscanf_s(file, "%d//%d", &v, &n);
-          triangle->v[2] = v - 1;
-          triangle++;
-          while (fscanf_s(file, "%d//%d", &v, &n) > 0)
-          {
-            triangle->v[0] = triangle[-1].v[0];
-            triangle->v[1] = triangle[-1].v[2];
-            triangle->v[2] = v - 1;
-            triangle++;
-          }
-        }
-        else if (sscanf_s(line, "%d/%d/%d", &v, &t, &n) == 3)
-        {
-          /* v/t/n */
-          triangle->v[0] = v - 1;
-          fscanf_s(file, "%d/%d/%d", &v, &t, &n);
-          triangle->v[1] = v - 1;
-          fscanf_s(file, "%d/%d/%d", &v, &t, &n);
-          triangle->v[2] = v - 1;
-          triangle++;
-          while (fscanf_s(file, "%d/%d/%d", &v, &t, &n) > 0)
-          {
-            triangle->v[0] = triangle[-1].v[0];
-            triangle->v[1] = triangle[-1].v[2];
-            triangle->v[2] = v - 1;
-            triangle++;
-          }
-        }
-        else if (sscanf_s(line, "%d/%d", &v, &t) == 2)
-        {
-          /* v/t */
-          triangle->v[0] = v - 1;
-          fscanf_s(file, "%d/%d", &v, &t);
-          triangle->v[1] = v - 1;
-          fscanf_s(file, "%d/%d", &v, &t);
-          triangle->v[2] = v - 1;
-          triangle++;
-          while (fscanf_s(file, "%d/%d", &v, &t) > 0)
-          {
-            triangle->v[0] = triangle[-1].v[0];
-            triangle->v[1] = triangle[-1].v[2];
-            triangle->v[2] = v - 1;
-            triangle++;
-          }
-        }
-        else
-        {
-          /* v */
-          sscanf_s(line, "%d", &v);
-          triangle->v[0] = v - 1;
-          fscanf_s(file, "%d", &v);
-          triangle->v[1] = v - 1;
-          fscanf_s(file, "%d", &v);
-          triangle->v[2] = v - 1;
-          triangle++;
-          while (fscanf_s(file, "%d", &v) > 0)
-          {
-            triangle->v[0] = triangle[-1].v[0];
-            triangle->v[1] = triangle[-1].v[2];
-            triangle->v[2] = v - 1;
-            triangle++;
-          }
-        }
-        break;
+        case 'v':
+          s = readVertex(s + 1, e, chunk.vertices.add());
+          break;
+
+        case 'f':
+          s = readFace(s + 1, e, chunk);
+          break;
       }
+    s = skipLine(s, e);
+  }
+}
 
-      default:
-        fgets(line, lineSize, file);
+// Chunks smaller than this are not worth a thread of their own.
+constexpr size_t minChunkSize = 4 << 20;
+
+inline int
+numberOfChunks(size_t size, int threads)
+{
+  if (threads <= 0)
+    threads = std::max(int(std::thread::hardware_concurrency()), 1);
+  return int(std::min(size / minChunkSize + 1, size_t(threads)));
+}
+
+void
+readMeshData(const char* s,
+  const char* e,
+  TriangleMesh::Data& data,
+  int threads)
+{
+  const auto n = numberOfChunks(e - s, threads);
+
+  if (n == 1)
+  {
+    MeshChunk chunk;
+
+    readMeshChunk(s, e, chunk);
+    data.numberOfVertices = chunk.vertices.size();
+    data.vertices = chunk.vertices.release();
+    data.vertexNormals = nullptr;
+    data.numberOfTriangles = chunk.triangles.size();
+    data.triangles = chunk.triangles.release();
+    return;
+  }
+
+  std::vector<const char*> bounds(n + 1);
+  std::vector<MeshChunk> chunks(n);
+  std::vector<std::thread> workers;
+
+  // Split the text into chunks that begin at the start of a line.
+  bounds[0] = s;
+  bounds[n] = e;
+  for (int i = 1; i < n; ++i)
+  {
+    auto b = std::max(s + (e - s) / n * i, bounds[i - 1]);
+    bounds[i] = b < e ? skipLine(b, e) : e;
+  }
+  workers.reserve(n);
+  for (int i = 0; i < n; ++i)
+    workers.emplace_back(readMeshChunk, bounds[i], bounds[i + 1],
+      std::ref(chunks[i]));
+  for (auto& w : workers)
+    w.join();
+  workers.clear();
+
+  // Prefix sums of the chunk sizes give the output offsets.
+  int nv{};
+  int nt{};
+
+  for (auto& chunk : chunks)
+  {
+    chunk.firstVertex = nv;
+    chunk.firstTriangle = nt;
+    nv += chunk.vertices.size();
+    nt += chunk.triangles.size();
+  }
+  data.numberOfVertices = nv;
+  data.vertices = nv > 0 ? new vec3f[nv] : nullptr;
+  data.vertexNormals = nullptr;
+  data.numberOfTriangles = nt;
+  data.triangles = nt > 0 ? new TriangleMesh::Triangle[nt] : nullptr;
+
+  auto stitch = [&data](MeshChunk& chunk)
+  {
+    if (auto size = chunk.vertices.size())
+      memcpy(data.vertices + chunk.firstVertex,
+        &chunk.vertices[0],
+        size * sizeof(vec3f));
+    if (auto size = chunk.triangles.size())
+    {
+      auto t = data.triangles + chunk.firstTriangle;
+      auto v = (int*)t;
+
+      memcpy(t, &chunk.triangles[0], size * sizeof(TriangleMesh::Triangle));
+      for (int i = 0, r = chunk.relativeIndices.size(); i < r; ++i)
+        v[chunk.relativeIndices[i]] += chunk.firstVertex;
     }
+    // The chunk buffers are freed as soon as they are copied
+    chunk.vertices.clear();
+    chunk.triangles.clear();
+    chunk.relativeIndices.clear();
+  };
+
+  for (int i = 1; i < n; ++i)
+    workers.emplace_back(stitch, std::ref(chunks[i]));
+  stitch(chunks[0]);
+  for (auto& w : workers)
+    w.join();
 }
 
 } // end namespace internal
@@ -234,24 +453,21 @@ readMeshData(FILE* file, TriangleMesh::Data& data)
 // MeshReader implementation
 // ==========
 TriangleMesh*
-MeshReader::readOBJ(const char* filename)
+MeshReader::readOBJ(const char* filename, int threads, bool optimize)
 {
-  FILE* file;
+  MappedFile file;
 
-  fopen_s(&file, filename, "r");
-  if (file == nullptr)
+  if (!file.open(filename))
     return nullptr;
+  printf("Reading Wavefront OBJ file %s...\n", filename);
 
   TriangleMesh::Data data;
 
-  internal::readMeshSize(file, data);
-  data.vertices = new vec3f[data.numberOfVertices];
-  data.vertexNormals = nullptr;
-  data.triangles = new TriangleMesh::Triangle[data.numberOfTriangles];
-  rewind(file);
-  printf("Reading Wavefront OBJ file %s...\n", filename);
-  internal::readMeshData(file, data);
-  fclose(file);
+  internal::readMeshData(file.data(), file.end(), data, threads);
+  file.close();
+
+  if (optimize)
+    MeshOptimizer::optimize(data);
 
   auto mesh = new TriangleMesh{data};
 
@@ -0,0 +1,501 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: MeshSimplifier.cpp
+// ========
+// Source file for quadric mesh simplifier.
+//
+// Author: Paulo Pagliosa
+// Last revision: 17/10/2026
+
+#include "geometry/MeshSimplifier.h"
+#include "geometry/MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace cg
+{ // begin namespace cg
+
+// Weight of the planes through boundary edges relative to the ones of
+// triangles of the same area
+static constexpr double boundaryWeight = 10;
+
+inline bool
+hasVertex(const TriangleMesh::Triangle& t, int v)
+{
+  return t.v[0] == v || t.v[1] == v || t.v[2] == v;
+}
+
+
+//////////////////////////////////////////////////////////
+//
+// MeshSimplifier implementation
+// ==============
+void
+MeshSimplifier::Quadric::setPlane(const vec3d& n, double d, double w)
+{
+  xx = w * n.x * n.x;
+  xy = w * n.x * n.y;
+  xz = w * n.x * n.z;
+  xw = w * n.x * d;
+  yy = w * n.y * n.y;
+  yz = w * n.y * n.z;
+  yw = w * n.y * d;
+  zz = w * n.z * n.z;
+  zw = w * n.z * d;
+  ww = w * d * d;
+  weight = w;
+}
+
+MeshSimplifier::Quadric&
+MeshSimplifier::Quadric::operator +=(const Quadric& q)
+{
+  xx += q.xx;
+  xy += q.xy;
+  xz += q.xz;
+  xw += q.xw;
+  yy += q.yy;
+  yz += q.yz;
+  yw += q.yw;
+  zz += q.zz;
+  zw += q.zw;
+  ww += q.ww;
+  weight += q.weight;
+  return *this;
+}
+
+double
+MeshSimplifier::Quadric::error(const vec3d& p) const
+{
+  const auto x = p.x;
+  const auto y = p.y;
+  const auto z = p.z;
+  auto e = xx * x * x + 2 * (xy * x * y + xz * x * z + xw * x) +
+    yy * y * y + 2 * (yz * y * z + yw * y) +
+    zz * z * z + 2 * zw * z +
+    ww;
+
+  return weight > 0 ? std::max(e / weight, 0.0) : 0;
+}
+
+bool
+MeshSimplifier::Quadric::minimize(vec3d& p) const
+{
+  // Solve A p = -b by Cramer's rule, A being the upper 3x3 block of the
+  // quadric, unless A is nearly singular, e.g., on flat regions
+  const auto c0 = yy * zz - yz * yz;
+  const auto c1 = xz * yz - xy * zz;
+  const auto c2 = xy * yz - xz * yy;
+  const auto det = xx * c0 + xy * c1 + xz * c2;
+  const auto trace = xx + yy + zz;
+
+  if (std::abs(det) <= 1e-6 * trace * trace * trace)
+    return false;
+
+  const auto c3 = xx * zz - xz * xz;
+  const auto c4 = xy * xz - xx * yz;
+  const auto c5 = xx * yy - xy * xy;
+  const auto s = -1 / det;
+
+  p.x = (c0 * xw + c1 * yw + c2 * zw) * s;
+  p.y = (c1 * xw + c3 * yw + c4 * zw) * s;
+  p.z = (c2 * xw + c4 * yw + c5 * zw) * s;
+  return true;
+}
+
+MeshSimplifier::MeshSimplifier(const TriangleMesh::Data& data):
+  _vertices(data.vertices, data.vertices + data.numberOfVertices),
+  _triangles(data.triangles, data.triangles + data.numberOfTriangles),
+  _removed(data.numberOfTriangles),
+  _locked(data.numberOfVertices),
+  _quadrics(data.numberOfVertices, Quadric{}),
+  _vertexTriangles(data.numberOfVertices),
+  _stamps(data.numberOfVertices),
+  _errors(data.numberOfVertices),
+  _triangleCount{data.numberOfTriangles}
+{
+  const auto nv = data.numberOfVertices;
+  const auto nt = data.numberOfTriangles;
+
+  // Lock the vertices with the same position as another one
+  {
+    std::vector<int> order(nv);
+
+    for (int i = 0; i < nv; ++i)
+      order[i] = i;
+
+    auto less = [this](int a, int b)
+    {
+      const auto& p = _vertices[a];
+      const auto& q = _vertices[b];
+
+      return p.x != q.x ? p.x < q.x : p.y != q.y ? p.y < q.y : p.z < q.z;
+    };
+
+    std::sort(order.begin(), order.end(), less);
+    for (int i = 1; i < nv; ++i)
+      if (_vertices[order[i]] == _vertices[order[i - 1]])
+        _locked[order[i]] = _locked[order[i - 1]] = 1;
+  }
+
+  std::vector<vec3d> normals(nt);
+  // Edges as (min vertex, max vertex) keys with their triangles
+  std::vector<std::pair<uint64_t, int>> edges;
+
+  edges.reserve(3 * size_t(nt));
+  for (int i = 0; i < nt; ++i)
+  {
+    const auto& t = _triangles[i];
+    const vec3d p0{_vertices[t.v[0]]};
+    auto n = (vec3d{_vertices[t.v[1]]} - p0).cross(vec3d{_vertices[t.v[2]]} - p0);
+    auto area = n.length() * 0.5;
+
+    if (area > 0)
+    {
+      Quadric q;
+
+      n *= 0.5 / area;
+      q.setPlane(n, -n.dot(p0), area);
+      for (auto v : t.v)
+        _quadrics[v] += q;
+      normals[i] = n;
+    }
+    for (int k = 0; k < 3; ++k)
+    {
+      auto a = t.v[k];
+      auto b = t.v[(k + 1) % 3];
+
+      _vertexTriangles[a].push_back(i);
+      if (a > b)
+        std::swap(a, b);
+      edges.emplace_back(uint64_t(a) << 32 | uint32_t(b), i);
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+  for (size_t i = 0, n = edges.size(); i < n;)
+  {
+    auto j = i + 1;
+
+    while (j < n && edges[j].first == edges[i].first)
+      ++j;
+
+    const auto v0 = int(edges[i].first >> 32);
+    const auto v1 = int(edges[i].first & 0xffffffff);
+
+    // An edge of a single triangle is on the boundary
+    if (j - i == 1)
+    {
+      const vec3d p0{_vertices[v0]};
+      auto e = vec3d{_vertices[v1]} - p0;
+      auto n = e.cross(normals[edges[i].second]).versor();
+      Quadric q;
+
+      q.setPlane(n, -n.dot(p0), boundaryWeight * e.squaredNorm());
+      _quadrics[v0] += q;
+      _quadrics[v1] += q;
+    }
+    push(v0, v1);
+    i = j;
+  }
+}
+
+void
+MeshSimplifier::push(int v0, int v1)
+{
+  // A locked vertex can only be kept, at its position, by a collapse
+  if (_locked[v1])
+  {
+    if (_locked[v0])
+      return;
+    std::swap(v0, v1);
+  }
+
+  auto q = _quadrics[v0];
+
+  q += _quadrics[v1];
+
+  // Try the optimal position, if any, the end points and the midpoint
+  const vec3d p0{_vertices[v0]};
+  const vec3d p1{_vertices[v1]};
+  vec3d candidates[4]{p0, p1, (p0 + p1) * 0.5};
+  auto n = _locked[v0] ? 1 : q.minimize(candidates[3]) ? 4 : 3;
+  auto best = 0;
+  double cost = q.error(p0);
+
+  for (int i = 1; i < n; ++i)
+  {
+    auto e = q.error(candidates[i]);
+
+    if (e < cost)
+    {
+      cost = e;
+      best = i;
+    }
+  }
+  _heap.push_back({float(cost),
+    v0,
+    v1,
+    _stamps[v0],
+    _stamps[v1],
+    vec3f{candidates[best]}});
+  std::push_heap(_heap.begin(), _heap.end(), std::greater<Collapse>{});
+}
+
+void
+MeshSimplifier::neighbors(int v, std::vector<int>& vertices) const
+{
+  vertices.clear();
+  for (auto t : _vertexTriangles[v])
+    if (!_removed[t])
+      for (auto w : _triangles[t].v)
+        if (w != v)
+          vertices.push_back(w);
+  std::sort(vertices.begin(), vertices.end());
+  vertices.erase(std::unique(vertices.begin(), vertices.end()),
+    vertices.end());
+}
+
+bool
+MeshSimplifier::isValid(const Collapse& c)
+{
+  if (_stamps[c.v0] != c.stamp0 || _stamps[c.v1] != c.stamp1)
+    return false;
+  // Link condition: the only vertices adjacent to both end points must
+  // be the opposite ones of the triangles sharing the edge
+  auto& n0 = _neighbors[0];
+  auto& n1 = _neighbors[1];
+  int shared = 0;
+
+  neighbors(c.v0, n0);
+  neighbors(c.v1, n1);
+  for (auto t : _vertexTriangles[c.v0])
+    if (!_removed[t] && hasVertex(_triangles[t], c.v1))
+      ++shared;
+
+  int common = 0;
+
+  for (auto i = n0.begin(), j = n1.begin(); i != n0.end() && j != n1.end();)
+    if (*i < *j)
+      ++i;
+    else if (*j < *i)
+      ++j;
+    else
+    {
+      ++common;
+      ++i;
+      ++j;
+    }
+  return common == shared && !flips(c.v0, c.v1, c.p) &&
+    !flips(c.v1, c.v0, c.p);
+}
+
+bool
+MeshSimplifier::flips(int v, int other, const vec3f& p) const
+{
+  for (auto i : _vertexTriangles[v])
+  {
+    if (_removed[i])
+      continue;
+
+    const auto& t = _triangles[i];
+
+    if (hasVertex(t, other))
+      continue;
+
+    // Vertices of t starting at v
+    auto k = t.v[0] == v ? 0 : t.v[1] == v ? 1 : 2;
+    const auto& a = _vertices[t.v[(k + 1) % 3]];
+    const auto& b = _vertices[t.v[(k + 2) % 3]];
+    auto n = (a - _vertices[v]).cross(b - _vertices[v]);
+    auto m = (a - p).cross(b - p);
+
+    if (m.dot(n) <= 0)
+      return true;
+  }
+  return false;
+}
+
+double
+MeshSimplifier::distance(int v, const vec3f& p) const
+{
+  // Distance from p to the farthest plane of the triangles of v
+  const vec3d q{p};
+  double d = 0;
+
+  for (auto i : _vertexTriangles[v])
+  {
+    if (_removed[i])
+      continue;
+
+    const auto& t = _triangles[i];
+    const vec3d p0{_vertices[t.v[0]]};
+    auto n = (vec3d{_vertices[t.v[1]]} - p0).cross(vec3d{_vertices[t.v[2]]} - p0);
+    auto length = n.length();
+
+    if (length > 0)
+      d = std::max(d, std::abs(n.dot(q - p0)) / length);
+  }
+  return d;
+}
+
+void
+MeshSimplifier::collapse(const Collapse& c)
+{
+  const auto v0 = c.v0;
+  const auto v1 = c.v1;
+  auto& triangles = _vertexTriangles[v0];
+
+  // The surface around the edge is within the errors of its end points
+  // of the original one, and the new vertex is within the distance to
+  // the farthest plane of the triangles around the edge of that surface
+  {
+    auto d = std::max(distance(v0, c.p), distance(v1, c.p));
+
+    _errors[v0] = float(std::max(_errors[v0], _errors[v1]) + d);
+    _maxError = std::max(_maxError, _errors[v0]);
+  }
+
+  // The triangles sharing the edge are removed, and the other ones of
+  // v1 are moved to v0
+  for (auto i : _vertexTriangles[v1])
+  {
+    if (_removed[i])
+      continue;
+
+    auto& t = _triangles[i];
+
+    if (hasVertex(t, v0))
+    {
+      _removed[i] = 1;
+      --_triangleCount;
+      continue;
+    }
+    for (auto& v : t.v)
+      if (v == v1)
+        v = v0;
+    triangles.push_back(i);
+  }
+  triangles.erase(std::remove_if(triangles.begin(),
+    triangles.end(),
+    [this](int i) { return _removed[i] != 0; }),
+    triangles.end());
+  std::vector<int>{}.swap(_vertexTriangles[v1]);
+  _vertices[v0] = c.p;
+  _quadrics[v0] += _quadrics[v1];
+  ++_stamps[v0];
+  _stamps[v1] = -1;
+  // The costs of the edges of v0 changed
+  neighbors(v0, _neighbors[0]);
+  for (auto v : _neighbors[0])
+    push(v0, v);
+}
+
+int
+MeshSimplifier::simplify(int triangleCount)
+{
+  while (_triangleCount > triangleCount && !_heap.empty())
+  {
+    std::pop_heap(_heap.begin(), _heap.end(), std::greater<Collapse>{});
+
+    auto c = _heap.back();
+
+    _heap.pop_back();
+    if (isValid(c))
+      collapse(c);
+  }
+  return _triangleCount;
+}
+
+TriangleMesh*
+MeshSimplifier::mesh() const
+{
+  std::vector<int> map(_vertices.size(), -1);
+  TriangleMesh::Data data;
+  int nv = 0;
+  int nt = 0;
+
+  data.triangles = new TriangleMesh::Triangle[_triangleCount];
+  for (size_t i = 0; i < _triangles.size(); ++i)
+  {
+    if (_removed[i])
+      continue;
+
+    auto& t = data.triangles[nt++];
+
+    for (int k = 0; k < 3; ++k)
+    {
+      auto& v = map[_triangles[i].v[k]];
+
+      if (v < 0)
+        v = nv++;
+      t.v[k] = v;
+    }
+  }
+  data.numberOfTriangles = nt;
+  data.numberOfVertices = nv;
+  data.vertices = new vec3f[nv];
+  data.vertexNormals = nullptr;
+  for (size_t i = 0; i < map.size(); ++i)
+    if (map[i] >= 0)
+      data.vertices[map[i]] = _vertices[i];
+  MeshOptimizer::optimize(data);
+
+  auto mesh = new TriangleMesh{data};
+
+  mesh->computeNormals();
+  return mesh;
+}
+
+void
+MeshSimplifier::buildLODs(TriangleMesh& mesh,
+  float ratio,
+  int minTriangleCount)
+{
+  auto target = int(mesh.data().numberOfTriangles * ratio);
+
+  if (target < minTriangleCount)
+    return;
+
+  MeshSimplifier simplifier{mesh.data()};
+  auto level = &mesh;
+
+  for (; target >= minTriangleCount; target = int(target * ratio))
+  {
+    auto count = simplifier.simplify(target);
+
+    // Stop if the mesh could not be simplified much further
+    if (count > level->data().numberOfTriangles * (1 + ratio) * 0.5f)
+      break;
+
+    auto lod = simplifier.mesh();
+
+    lod->lodError = simplifier.error();
+    level->lod = lod;
+    level = lod;
+  }
+}
+
+} // end namespace cg
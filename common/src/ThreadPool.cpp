@@ -0,0 +1,183 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: ThreadPool.cpp
+// ========
+// Source file for work-stealing thread pool.
+//
+// Author: Paulo Pagliosa
+// Last revision: 17/10/2026
+
+#include "utils/ThreadPool.h"
+#include <algorithm>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// ThreadPool implementation
+// ==========
+ThreadPool::ThreadPool(int threadCount)
+{
+  if (threadCount <= 0)
+    threadCount = std::max(int(std::thread::hardware_concurrency()), 1);
+  for (int i = 0; i < threadCount; ++i)
+    _queues.emplace_back(new Queue);
+  // The queue 0 belongs to the thread calling run()
+  for (int i = 1; i < threadCount; ++i)
+    _threads.emplace_back(&ThreadPool::loop, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    _stop = true;
+  }
+  _start.notify_all();
+  for (auto& thread : _threads)
+    thread.join();
+}
+
+bool
+ThreadPool::pop(int queue, int& task)
+{
+  auto& q = *_queues[queue];
+  std::lock_guard<std::mutex> lock{q.mutex};
+
+  if (q.tasks.empty())
+    return false;
+  task = q.tasks.front();
+  q.tasks.pop_front();
+  return true;
+}
+
+bool
+ThreadPool::steal(int queue, int& task)
+{
+  const auto n = size();
+
+  for (int i = 1; i < n; ++i)
+  {
+    auto& q = *_queues[(queue + i) % n];
+    std::lock_guard<std::mutex> lock{q.mutex};
+
+    if (!q.tasks.empty())
+    {
+      task = q.tasks.back();
+      q.tasks.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+int
+ThreadPool::work(int queue, const Task& f)
+{
+  int task;
+  int count = 0;
+
+  while (pop(queue, task) || steal(queue, task))
+  {
+    f(task);
+    ++count;
+  }
+  return count;
+}
+
+void
+ThreadPool::loop(int queue)
+{
+  int batch = 0;
+  std::unique_lock<std::mutex> lock{_mutex};
+
+  for (;;)
+  {
+    _start.wait(lock, [&]()
+    {
+      return _stop || (_batch != batch && _task != nullptr);
+    });
+    if (_stop)
+      return;
+    batch = _batch;
+
+    // Keep the task of the batch, since a new one can be set only after
+    // this thread is done (see run())
+    const auto& task = *_task;
+
+    ++_active;
+    lock.unlock();
+
+    auto count = work(queue, task);
+
+    lock.lock();
+    _remaining -= count;
+    if (--_active == 0)
+      _done.notify_all();
+  }
+}
+
+void
+ThreadPool::run(int n, const Task& task)
+{
+  if (n <= 0)
+    return;
+
+  std::unique_lock<std::mutex> lock{_mutex};
+
+  // Wait for threads woken too late for the last batch to find out it
+  // is over, so that none of them runs a task of this batch
+  _done.wait(lock, [this]() { return _active == 0; });
+
+  // Give each thread a contiguous range of tasks, which keeps nearby
+  // tasks (e.g., neighboring image tiles) on the same thread
+  const auto threadCount = size();
+
+  for (int i = 0; i < threadCount; ++i)
+  {
+    auto& q = *_queues[i];
+    std::lock_guard<std::mutex> qlock{q.mutex};
+
+    for (auto t = n * i / threadCount, e = n * (i + 1) / threadCount; t < e;)
+      q.tasks.push_back(t++);
+  }
+  _task = &task;
+  _remaining = n;
+  ++_batch;
+  lock.unlock();
+  _start.notify_all();
+
+  auto count = work(0, task);
+
+  lock.lock();
+  _remaining -= count;
+  _done.wait(lock, [this]() { return _remaining == 0 && _active == 0; });
+  _task = nullptr;
+}
+
+} // end namespace cg
@@ -31,6 +31,8 @@
 // Last revision: 15/09/2018
 
 #include "geometry/TriangleMesh.h"
+#include <atomic>
+#include <cstring>
 #include <memory>
 
 namespace cg
@@ -41,7 +43,7 @@ namespace cg
 //
 // TriangleMesh implementation
 // ============
-static uint32_t nextMeshId;
+static std::atomic<uint32_t> nextMeshId;
 
 TriangleMesh::TriangleMesh(const Data& data):
   id{++nextMeshId},
@@ -50,8 +52,22 @@ TriangleMesh::TriangleMesh(const Data& data):
   // do nothing
 }
 
+TriangleMesh::TriangleMesh(const Data& data,
+  const Bounds3f& bounds,
+  SharedObject* storage):
+  id{++nextMeshId},
+  _data{data},
+  _storage{storage},
+  _bounds{bounds},
+  _hasBounds{true}
+{
+  // do nothing
+}
+
 TriangleMesh::~TriangleMesh()
 {
+  if (_storage != nullptr)
+    return;
   delete []_data.vertices;
   delete []_data.vertexNormals;
   delete []_data.triangles;
@@ -60,11 +76,14 @@ TriangleMesh::~TriangleMesh()
 Bounds3f
 TriangleMesh::bounds() const
 {
-  Bounds3f bounds;
-
-  for (int i = 0; i < _data.numberOfVertices; i++)
-    bounds.inflate(_data.vertices[i]);
-  return bounds;
+  if (!_hasBounds)
+  {
+    _bounds.setEmpty();
+    for (int i = 0; i < _data.numberOfVertices; i++)
+      _bounds.inflate(_data.vertices[i]);
+    _hasBounds = true;
+  }
+  return _bounds;
 }
 
 void
@@ -100,6 +119,7 @@ TriangleMesh::TRS(const mat4f& trs)
 
   for (int i = 0; i < nv; ++i)
     _data.vertices[i] = trs.transform3x4(_data.vertices[i]);
+  _hasBounds = false;
   if (_data.vertexNormals == nullptr)
     return;
 
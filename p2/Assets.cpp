@@ -31,7 +31,9 @@
 // Last revision: 15/10/2019
 
 #include "Assets.h"
+#include "geometry/MeshSimplifier.h"
 #include "graphics/Application.h"
+#include "utils/MeshCache.h"
 #include <filesystem>
 
 namespace cg
@@ -45,6 +47,7 @@ namespace fs = std::filesystem;
 // Assets implementation
 // ======
 MeshMap Assets::_meshes;
+std::map<std::string, MeshLoadRef> Assets::_loads;
 
 void
 Assets::initialize()
@@ -61,6 +64,26 @@ Assets::initialize()
   }
 }
 
+static TriangleMesh*
+readMesh(const std::string& name)
+{
+  auto filename = Application::assetFilePath("meshes/") + name;
+  auto cacheFilename = Application::assetFilePath("cache/meshes/")
+    + name
+    + MeshCache::extension;
+  auto m = MeshCache::read(cacheFilename.c_str(), filename.c_str());
+
+  // The levels of detail are built here, on the loader thread, and
+  // cached with the mesh
+  if (m == nullptr)
+    if ((m = MeshReader::readOBJ(filename.c_str())) != nullptr)
+    {
+      MeshSimplifier::buildLODs(*m);
+      MeshCache::write(cacheFilename.c_str(), filename.c_str(), *m);
+    }
+  return m;
+}
+
 TriangleMesh*
 Assets::loadMesh(MeshMapIterator mit)
 {
@@ -71,12 +94,84 @@ Assets::loadMesh(MeshMapIterator mit)
 
   if (m == nullptr)
   {
-    auto filename = "meshes/" + mit->first;
+    auto lit = _loads.find(mit->first);
 
-    m = Application::loadMesh(filename.c_str());
+    if (lit != _loads.end())
+    {
+      m = lit->second->wait();
+      _loads.erase(lit);
+    }
+    else
+      m = readMesh(mit->first);
     _meshes[mit->first] = m;
   }
   return m;
 }
 
+MeshLoadRef
+Assets::loadMeshAsync(MeshMapIterator mit)
+{
+  if (mit == _meshes.end())
+    return nullptr;
+  if (mit->second != nullptr)
+    return new MeshLoad{mit->first, mit->second};
+
+  auto& load = _loads[mit->first];
+
+  if (load == nullptr)
+    // The worker only touches CPU memory; GL buffers are created later,
+    // on the render thread, the first time the mesh is drawn.
+    load = new MeshLoad{mit->first,
+      std::async(std::launch::async, readMesh, mit->first)};
+  return load;
+}
+
+bool
+Assets::isLoading(MeshMapIterator mit)
+{
+  return _loads.find(mit->first) != _loads.end();
+}
+
+void
+Assets::update()
+{
+  for (auto lit = _loads.begin(); lit != _loads.end();)
+    if (!lit->second->isReady())
+      ++lit;
+    else
+    {
+      _meshes[lit->first] = lit->second->mesh();
+      lit = _loads.erase(lit);
+    }
+}
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// MeshLoad implementation
+// ========
+bool
+MeshLoad::isReady()
+{
+  using namespace std::chrono_literals;
+
+  if (!_done && _future.wait_for(0s) == std::future_status::ready)
+  {
+    _mesh = _future.get();
+    _done = true;
+  }
+  return _done;
+}
+
+TriangleMesh*
+MeshLoad::wait()
+{
+  if (!_done)
+  {
+    _mesh = _future.get();
+    _done = true;
+  }
+  return _mesh;
+}
+
 } // end namespace cg
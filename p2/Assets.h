@@ -34,6 +34,7 @@
 #define __Assets_h
 
 #include "utils/MeshReader.h"
+#include <future>
 #include <map>
 #include <string>
 
@@ -45,6 +46,66 @@ using MeshMap = std::map<std::string, MeshRef>;
 using MeshMapIterator = typename MeshMap::const_iterator;
 
 
+/////////////////////////////////////////////////////////////////////
+//
+// MeshLoad: handle of a mesh being loaded in background
+// ========
+class MeshLoad: public SharedObject
+{
+public:
+  /// Constructs a handle of a mesh loaded by \c future.
+  MeshLoad(const std::string& name, std::future<TriangleMesh*>&& future):
+    _name{name},
+    _future{std::move(future)}
+  {
+    // do nothing
+  }
+
+  /// Constructs a handle of a mesh already loaded.
+  MeshLoad(const std::string& name, TriangleMesh* mesh):
+    _name{name},
+    _mesh{mesh},
+    _done{true}
+  {
+    // do nothing
+  }
+
+  /// Destructor. Waits for the load, if it is still in flight.
+  ~MeshLoad() override
+  {
+    wait();
+  }
+
+  /// Returns the name of the mesh.
+  const std::string& name() const
+  {
+    return _name;
+  }
+
+  /// Returns true if the load is finished. Never blocks.
+  bool isReady();
+
+  /// \brief Returns the loaded mesh, or null if the load is not
+  /// finished or failed. Never blocks.
+  TriangleMesh* mesh()
+  {
+    return isReady() ? _mesh.get() : nullptr;
+  }
+
+  /// Blocks until the load is finished and returns the loaded mesh.
+  TriangleMesh* wait();
+
+private:
+  std::string _name;
+  std::future<TriangleMesh*> _future;
+  MeshRef _mesh;
+  bool _done{};
+
+}; // MeshLoad
+
+using MeshLoadRef = Reference<MeshLoad>;
+
+
 /////////////////////////////////////////////////////////////////////
 //
 // Assets: assets class
@@ -61,8 +122,21 @@ public:
 
   static TriangleMesh* loadMesh(MeshMapIterator mit);
 
+  /// \brief Starts loading a mesh on a worker thread and returns
+  /// its handle. Requests for a mesh in flight share the same handle.
+  /// The handle is released with its last reference, so the result
+  /// may be discarded.
+  static MeshLoadRef loadMeshAsync(MeshMapIterator mit);
+
+  /// Returns true if the mesh is being loaded in background.
+  static bool isLoading(MeshMapIterator mit);
+
+  /// Moves the meshes loaded in background into the mesh map.
+  static void update();
+
 private:
   static MeshMap _meshes;
+  static std::map<std::string, MeshLoadRef> _loads;
 
 }; // Assets
 
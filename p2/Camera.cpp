@@ -43,7 +43,7 @@ namespace cg
 Camera* Camera::_current;
 
 Camera::Camera(float aspect):
-  Component{"Camera"},
+  Component{"Camera", componentTypeId},
   _viewAngle{60},
   _height{10},
   _aspectRatio{aspect},
@@ -135,16 +135,18 @@ void
 Camera::updateView() const
 {
   auto t = const_cast<Camera*>(this)->transform();
+  // Reading the position of a dirty transform computes its world data,
+  // which sets its changed flag
+  const auto& p = t->position();
 
-  if (!t->changed)
+  if (!t->changed())
     return;
 
-  const auto& p = t->position();
   auto r = mat3f{t->rotation()};
 
   _worldToCameraMatrix = lookAt(p, r[0], r[1], r[2]);
   _cameraToWorldMatrix.set(r, p);
-  t->changed = false;
+  t->setChanged(false);
 }
 
 void
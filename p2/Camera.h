@@ -46,6 +46,8 @@ namespace cg
 class Camera final: public Component
 {
 public:
+  static constexpr ComponentTypeId componentTypeId =
+    componentTypeIdOf<Camera>();
   static constexpr float minAngle = 1;
   static constexpr float maxAngle = 179;
   static constexpr float minHeight = 0.01f;
@@ -168,6 +170,19 @@ vpMatrix(const Camera* c)
   return c->projectionMatrix() * c->worldToCameraMatrix();
 }
 
+/// \brief Returns the size in pixels of a sphere of diameter \c d at a
+/// distance \c z from the camera \c c, in a viewport \c h pixels high.
+inline float
+projectedSize(const Camera* c, float d, float z, int h)
+{
+  if (c->projectionType() == Camera::Parallel)
+    return d * h / c->height();
+
+  auto t = (float)tan(c->viewAngle() * 0.5f * M_PI / 180);
+
+  return d * h / (2 * t * std::max(z, Camera::minFrontPlane));
+}
+
 } // end namespace cg
 
 #endif // __Camera_h
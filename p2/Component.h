@@ -34,6 +34,8 @@
 #define __Component_h
 
 #include "core/SharedObject.h"
+#include <cstdint>
+#include <type_traits>
 
 namespace cg
 { // begin namespace cg
@@ -41,6 +43,68 @@ namespace cg
 // Forward definitions
 class SceneObject;
 class Transform;
+class Primitive;
+class Camera;
+
+// Id of a component type. Each subclass T of Component is listed once in
+// ComponentTypes, declares its id as the constant
+// T::componentTypeId = componentTypeIdOf<T>(), its index in the list,
+// and passes it to the constructor of Component
+using ComponentTypeId = int;
+using ComponentMask = uint32_t;
+
+constexpr int maxComponentTypes = 32;
+
+template <typename... Types>
+struct ComponentTypeList
+{
+  static constexpr int size = sizeof...(Types);
+
+  /// Returns the number of occurrences of T in this list.
+  template <typename T>
+  static constexpr int count()
+  {
+    return (0 + ... + int(std::is_same_v<T, Types>));
+  }
+
+  /// Returns the index of the first occurrence of T in this list, or -1.
+  template <typename T>
+  static constexpr int indexOf()
+  {
+    constexpr bool match[]{std::is_same_v<T, Types>...};
+
+    for (int i = 0; i < size; ++i)
+      if (match[i])
+        return i;
+    return -1;
+  }
+
+}; // ComponentTypeList
+
+using ComponentTypes = ComponentTypeList<Transform, Primitive, Camera>;
+
+static_assert(ComponentTypes::size <= maxComponentTypes,
+  "Too many component types");
+
+/// Returns the id of the component type T.
+template <typename T>
+constexpr ComponentTypeId
+componentTypeIdOf()
+{
+  static_assert(ComponentTypes::count<T>() == 1,
+    "Component type not listed once in ComponentTypes");
+  return ComponentTypes::indexOf<T>();
+}
+
+/// Returns the bit of the component type T in a component mask.
+template <typename T>
+constexpr ComponentMask
+componentMask()
+{
+  static_assert(T::componentTypeId >= 0 &&
+    T::componentTypeId < maxComponentTypes, "Bad component type id");
+  return ComponentMask(1) << T::componentTypeId;
+}
 
 
 /////////////////////////////////////////////////////////////////////
@@ -56,6 +120,27 @@ public:
     return _typeName;
   }
 
+  /// Returns the type id of this component.
+  auto typeId() const
+  {
+    return _typeId;
+  }
+
+  /// \brief Returns this component as a T, or null if it is not of type
+  /// T. The type ids are compared, with no RTTI.
+  template <typename T>
+  T* as()
+  {
+    return _typeId == T::componentTypeId ? static_cast<T*>(this) : nullptr;
+  }
+
+  template <typename T>
+  const T* as() const
+  {
+    return _typeId == T::componentTypeId ?
+      static_cast<const T*>(this) : nullptr;
+  }
+
   /// Returns the scene object owning this component.
   auto sceneObject() const
   {
@@ -66,14 +151,16 @@ public:
   Transform* transform(); // implemented in SceneObject.h
 
 protected:
-  Component(const char* const typeName):
-    _typeName{typeName}
+  Component(const char* const typeName, ComponentTypeId typeId):
+    _typeName{typeName},
+    _typeId{typeId}
   {
     // do nothing
   }
 
 private:
   const char* const _typeName;
+  const ComponentTypeId _typeId;
   SceneObject* _sceneObject{};
 
   friend class SceneObject;
@@ -0,0 +1,208 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: ComponentStore.h
+// ========
+// Class definition for component store.
+//
+// Author(s): Paulo Pagliosa, Carlos Monteiro e Yago Mescolotte
+// Last revision: 17/10/2026
+
+#ifndef __ComponentStore_h
+#define __ComponentStore_h
+
+#include "core/SharedObject.h"
+#include <vector>
+
+namespace cg
+{ // begin namespace cg
+
+// Forward definitions
+class Camera;
+class Primitive;
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// ComponentArray: component array class
+// ==============
+//
+// Holds the components of a type in a dense array, together with the
+// ids of the entities (scene objects) owning them, and maps an entity
+// id to the index of its component, or -1 if none. An entity has at
+// most one component of the type. Removing a component moves the last
+// one into its place, so the order of the components is not kept.
+template <typename T>
+class ComponentArray
+{
+public:
+  /// Returns the number of components of this array.
+  int size() const
+  {
+    return int(_components.size());
+  }
+
+  /// Returns the i-th component of this array.
+  T* operator [](int i) const
+  {
+    return _components[i];
+  }
+
+  /// Returns the id of the entity owning the i-th component.
+  int entity(int i) const
+  {
+    return _entities[i];
+  }
+
+  /// Returns the component of \c entity, or null if none.
+  T* get(int entity) const
+  {
+    if (entity >= int(_index.size()) || _index[entity] < 0)
+      return nullptr;
+    return _components[_index[entity]];
+  }
+
+  auto begin() const
+  {
+    return _components.begin();
+  }
+
+  auto end() const
+  {
+    return _components.end();
+  }
+
+  /// Sets the component of \c entity.
+  void add(int entity, T* component)
+  {
+    if (entity >= int(_index.size()))
+      _index.resize(entity + 1, -1);
+    if (_index[entity] >= 0)
+      _components[_index[entity]] = component;
+    else
+    {
+      _index[entity] = size();
+      _components.push_back(component);
+      _entities.push_back(entity);
+    }
+  }
+
+  /// Removes the component of \c entity, if any.
+  void remove(int entity)
+  {
+    if (entity >= int(_index.size()) || _index[entity] < 0)
+      return;
+
+    auto i = _index[entity];
+    auto last = _entities.back();
+
+    _components[i] = _components.back();
+    _entities[i] = last;
+    _index[last] = i;
+    _index[entity] = -1;
+    _components.pop_back();
+    _entities.pop_back();
+  }
+
+private:
+  std::vector<T*> _components;
+  std::vector<int> _entities;
+  std::vector<int> _index;
+
+}; // ComponentArray
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// ComponentStore: component store class
+// ==============
+//
+// Holds the components of the scene objects of a scene, other than
+// their transforms (see TransformStore), in one component array per
+// type. Each scene object is an entity whose id indexes the arrays, so
+// the component of a type of a scene object is found in constant time,
+// and the systems of the scene iterate over the components of a type
+// without traversing the hierarchy. The components are owned by their
+// scene objects.
+class ComponentStore: public SharedObject
+{
+public:
+  /// Returns the component array of type T.
+  template <typename T>
+  const ComponentArray<T>& components() const;
+
+  /// Returns a new entity id, reusing the ones of destroyed entities.
+  int createEntity()
+  {
+    if (_free.empty())
+      return _entityCount++;
+
+    auto entity = _free.back();
+
+    _free.pop_back();
+    return entity;
+  }
+
+  /// Removes the components of \c entity and frees its id.
+  void destroyEntity(int entity)
+  {
+    _primitives.remove(entity);
+    _cameras.remove(entity);
+    _free.push_back(entity);
+  }
+
+private:
+  ComponentArray<Primitive> _primitives;
+  ComponentArray<Camera> _cameras;
+  std::vector<int> _free;
+  int _entityCount{};
+
+  template <typename T>
+  ComponentArray<T>& array()
+  {
+    return const_cast<ComponentArray<T>&>(components<T>());
+  }
+
+  friend class SceneObject;
+
+}; // ComponentStore
+
+template <>
+inline const ComponentArray<Primitive>&
+ComponentStore::components<Primitive>() const
+{
+  return _primitives;
+}
+
+template <>
+inline const ComponentArray<Camera>&
+ComponentStore::components<Camera>() const
+{
+  return _cameras;
+}
+
+} // end namespace cg
+
+#endif // __ComponentStore_h
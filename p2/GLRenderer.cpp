@@ -47,13 +47,6 @@ GLRenderer::update()
   // TODO
 }
 
-inline void
-drawMesh(GLMesh* mesh, GLuint mode)
-{
-	glPolygonMode(GL_FRONT_AND_BACK, mode);
-	glDrawElements(GL_TRIANGLES, mesh->vertexCount(), GL_UNSIGNED_INT, 0);
-}
-
 void
 GLRenderer::render()
 {
@@ -66,50 +59,58 @@ GLRenderer::render()
 	const auto& p = _camera->transform()->position();
 	auto vp = vpMatrix(_camera);
 
-	_program->setUniformMat4("vpMatrix", vp);
-	_program->setUniformVec4("ambientLight", _sceneCurrent->ambientLight);
-	_program->setUniformVec3("lightPosition", p);
+	_queue.setFrame(vp, _sceneCurrent->ambientLight, p);
 
-	Reference<SceneObject> obj = _sceneCurrent->root();
-	renderRecursivo(obj);
+	_queue.clear();
+	collect(vp);
+	_queue.submit();
 }
 
 void
-GLRenderer::renderRecursivo(Reference<SceneObject>& object)
+GLRenderer::collect(const mat4f& vp)
 {
-	auto begin = object->IteratorSceneObject();
-	auto end = object->IteratorEndSceneObject();
-	for (auto it = begin; it != end; it++)
+	// The scene BVH holds the visible primitives with a loaded mesh and
+	// their world bounds, refit as their transforms change
+	auto& bvh = _sceneCurrent->bvh();
+	const auto& eye = _camera->transform()->position();
+
+	bvh.update();
+	_candidates.clear();
+	bvh.cull(Frustumf{vp}, [&](int i)
 	{
-		if (!(*it)->visible)
-			continue;
-
-		renderRecursivo(*it);
-
-		Component* primitiveCurrent = nullptr;
-		auto begin = (*it)->IteratorComponent();
-		auto end = (*it)->IteratorEndComponent();
-
-		for (auto component = begin; component != end; component++)
-		{
-			if (auto primitive = dynamic_cast<Primitive*>((*component).get()))
-			{
-				auto m = glMesh(primitive->mesh());
-
-				if (nullptr == m)
-					return;
-
-				auto t = primitive->transform();
-				auto normalMatrix = mat3f{ t->worldToLocalMatrix() }.transposed();
-
-				_program->setUniformMat4("transform", t->localToWorldMatrix());
-				_program->setUniformMat3("normalMatrix", normalMatrix);
-				_program->setUniformVec4("color", primitive->color);
-				_program->setUniform("flatMode", (int)0);
-				m->bind();
-				drawMesh(m, GL_FILL);
-			}
-		}
+		_candidates.push_back({bvh.primitive(i),
+			bvh.mesh(i),
+			bvh.primitiveBounds(i)});
+	});
+	_stats.primitiveCount = int(bvh.size());
+	_stats.frustumCulledCount = _stats.primitiveCount - int(_candidates.size());
+	_stats.occluderCount = _stats.occlusionCulledCount = 0;
+	if (_occlusionCulling)
+	{
+		_occlusionCuller.cull(_candidates, vp, eye, _W, _H);
+		_stats.occluderCount = _occlusionCuller.stats().occluderCount;
+		_stats.occlusionCulledCount = _occlusionCuller.stats().culledCount;
+	}
+	_stats.triangleCount = 0;
+	for (const auto& c : _candidates)
+	{
+		auto t = c.primitive->transform();
+		auto depth = (t->position() - eye).squaredNorm();
+		// The level of detail is chosen by the size of the bounds on screen
+		auto size = projectedSize(_camera,
+			c.bounds.diagonalLength(),
+			(c.bounds.center() - eye).length(),
+			_H);
+		auto mesh = c.mesh->levelOfDetail(size);
+
+		_stats.triangleCount += mesh->data().numberOfTriangles;
+		_queue.add(*_program,
+			*glMesh(mesh),
+			*t,
+			c.primitive->color,
+			GL_FILL,
+			false,
+			depth);
 	}
 }
 
@@ -33,6 +33,8 @@
 #ifndef __GLRenderer_h
 #define __GLRenderer_h
 
+#include "OcclusionCuller.h"
+#include "RenderQueue.h"
 #include "Renderer.h"
 #include "graphics/GLGraphics3.h"
 
@@ -47,17 +49,30 @@ namespace cg
 class GLRenderer: public Renderer
 {
 public:
+  /// Counts of the last render.
+  struct Stats
+  {
+    int primitiveCount;
+    int frustumCulledCount;
+    int occluderCount;
+    int occlusionCulledCount;
+    int triangleCount;
+
+  }; // Stats
+
   GLRenderer(Scene& scene, GLSL::Program* program, Color selectedWireframeColor, Camera* camera = nullptr):
     Renderer{scene, camera}
   {
 		_program = program;
 		_selectedWireframeColor = selectedWireframeColor;
+		_queue.addProgram(*program);
   }
 
 	GLRenderer(Scene& scene, GLSL::Program* program, Camera* camera = nullptr) :
 		Renderer{ scene, camera }
 	{
 		_program = program;
+		_queue.addProgram(*program);
 	}
 
   void update() override;
@@ -65,17 +80,48 @@ public:
 
 	void setProgram(GLSL::Program* program) {
 		_program = program;
+		_queue.addProgram(*program);
 	}
 
 	auto getProgram() {
 		return _program;
 	}
 
+	/// Sets the instanced variant of the program, or none if null.
+	void setInstancedProgram(GLSL::Program* program) {
+		_queue.addProgram(*_program, program);
+	}
+
+	auto occlusionCulling() const {
+		return _occlusionCulling;
+	}
+
+	/// Enables or disables the occlusion culling of this renderer.
+	void setOcclusionCulling(bool enabled) {
+		if (!enabled)
+			_occlusionCuller.reset();
+		_occlusionCulling = enabled;
+	}
+
+	const Stats& stats() const {
+		return _stats;
+	}
+
+	/// Returns the stats of the render queue of this renderer.
+	const RenderQueue::Stats& queueStats() const {
+		return _queue.stats();
+	}
+
 private:
 	GLSL::Program* _program;
 	Color _selectedWireframeColor{ 255, 102, 0 };
+	RenderQueue _queue;
+	OcclusionCuller _occlusionCuller;
+	std::vector<OcclusionCuller::Candidate> _candidates;
+	bool _occlusionCulling{false};
+	Stats _stats{};
 
-	void renderRecursivo(Reference<SceneObject>& );
+	void collect(const mat4f&);
 }; // GLRenderer
 
 } // end namespace cg
@@ -0,0 +1,349 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: OcclusionCuller.cpp
+// ========
+// Source file for Hi-Z occlusion culler.
+//
+// Author(s): Paulo Pagliosa, Carlos Monteiro e Yago Mescolotte
+// Last revision: 17/10/2026
+
+#include "OcclusionCuller.h"
+#include "SceneObject.h"
+#include "graphics/Application.h"
+#include <algorithm>
+#include <cmath>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// OcclusionCuller implementation
+// ===============
+OcclusionCuller::~OcclusionCuller()
+{
+  if (_depthFramebuffer == 0)
+    return;
+  glDeleteFramebuffers(1, &_depthFramebuffer);
+  glDeleteFramebuffers(1, &_resultFramebuffer);
+  glDeleteTextures(1, &_depthTexture);
+  glDeleteTextures(1, &_resultTexture);
+  glDeleteBuffers(1, &_pixelBuffer);
+  glDeleteVertexArrays(1, &_emptyVAO);
+  glDeleteVertexArrays(1, &_boundsVAO);
+}
+
+void
+OcclusionCuller::initialize()
+{
+  Application::loadShaders(_depthProgram,
+    "shaders/hiz_depth.vs",
+    "shaders/hiz_depth.fs");
+  Application::loadShaders(_reduceProgram,
+    "shaders/hiz_reduce.vs",
+    "shaders/hiz_reduce.fs");
+  Application::loadShaders(_testProgram,
+    "shaders/hiz_test.vs",
+    "shaders/hiz_test.fs");
+  glGenFramebuffers(1, &_depthFramebuffer);
+  glGenFramebuffers(1, &_resultFramebuffer);
+  glGenTextures(1, &_depthTexture);
+  glGenTextures(1, &_resultTexture);
+  glGenBuffers(1, &_pixelBuffer);
+  glGenVertexArrays(1, &_emptyVAO);
+  glGenVertexArrays(1, &_boundsVAO);
+  glBindTexture(GL_TEXTURE_2D, _depthTexture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+  glBindTexture(GL_TEXTURE_2D, _resultTexture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  // The depth framebuffer has no color buffer
+  glBindFramebuffer(GL_FRAMEBUFFER, _depthFramebuffer);
+  glDrawBuffer(GL_NONE);
+  glReadBuffer(GL_NONE);
+}
+
+void
+OcclusionCuller::resize(int width, int height)
+{
+  if (width == _W && height == _H)
+    return;
+  _W = width;
+  _H = height;
+  _levelCount = 1;
+  while ((std::max(_W, _H) >> _levelCount) > 0)
+    ++_levelCount;
+  glBindTexture(GL_TEXTURE_2D, _depthTexture);
+  for (int level = 0; level < _levelCount; ++level)
+    glTexImage2D(GL_TEXTURE_2D,
+      level,
+      GL_DEPTH_COMPONENT32F,
+      std::max(1, _W >> level),
+      std::max(1, _H >> level),
+      0,
+      GL_DEPTH_COMPONENT,
+      GL_FLOAT,
+      nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, _levelCount - 1);
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void
+OcclusionCuller::reset()
+{
+  _tested.clear();
+  _occluded.clear();
+}
+
+void
+OcclusionCuller::readResults()
+{
+  _occluded.clear();
+  if (_tested.empty())
+    return;
+  // Results of the previous frame, whose draws are done by now
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, _pixelBuffer);
+
+  auto n = _tested.size();
+  auto results = (const GLubyte*)glMapBufferRange(GL_PIXEL_PACK_BUFFER,
+    0,
+    n,
+    GL_MAP_READ_BIT);
+
+  if (results != nullptr)
+  {
+    for (size_t i = 0; i < n; ++i)
+      if (results[i] == 0)
+        _occluded.insert(_tested[i]);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  _tested.clear();
+}
+
+void
+OcclusionCuller::selectOccluders(const std::vector<Candidate>& candidates,
+  const vec3f& eye)
+{
+  // A sphere of radius r at a distance d subtends an angle 2 asin(r/d)
+  const auto minSize = (float)sin(occluderAngle * 0.5f);
+
+  _occluders.clear();
+  for (int i = 0, n = int(candidates.size()); i < n; ++i)
+  {
+    const auto& b = candidates[i].bounds;
+    auto r = b.diagonalLength() * 0.5f;
+    auto d = (b.center() - eye).length();
+    // The eye is in the bounding sphere of the nearest ones
+    auto size = d > r ? r / d : 1.0f;
+
+    if (size >= minSize)
+      _occluders.emplace_back(size, i);
+  }
+  if (int(_occluders.size()) > maxOccluders)
+  {
+    std::partial_sort(_occluders.begin(),
+      _occluders.begin() + maxOccluders,
+      _occluders.end(),
+      [](const auto& a, const auto& b) { return a.first > b.first; });
+    _occluders.resize(maxOccluders);
+  }
+}
+
+void
+OcclusionCuller::drawOccluders(const std::vector<Candidate>& candidates,
+  const mat4f& vpMatrix)
+{
+  glBindFramebuffer(GL_FRAMEBUFFER, _depthFramebuffer);
+  glFramebufferTexture2D(GL_FRAMEBUFFER,
+    GL_DEPTH_ATTACHMENT,
+    GL_TEXTURE_2D,
+    _depthTexture,
+    0);
+  glViewport(0, 0, _W, _H);
+  glClear(GL_DEPTH_BUFFER_BIT);
+  _depthProgram.use();
+
+  auto mvp = _depthProgram.uniformLocation("mvpMatrix");
+
+  for (const auto& occluder : _occluders)
+  {
+    const auto& c = candidates[occluder.second];
+    auto m = glMesh(c.mesh);
+
+    GLSL::Program::setUniformMat4(mvp,
+      vpMatrix * c.primitive->transform()->localToWorldMatrix() *
+      m->positionMatrix());
+    m->bind();
+    glDrawElements(GL_TRIANGLES, m->vertexCount(), m->indexType(), 0);
+  }
+}
+
+void
+OcclusionCuller::buildHiZ()
+{
+  // Each level is drawn reading the one below it, which is made the
+  // only level of the texture so that no feedback loop is formed
+  _reduceProgram.use();
+  glBindVertexArray(_emptyVAO);
+  glBindTexture(GL_TEXTURE_2D, _depthTexture);
+  glDepthFunc(GL_ALWAYS);
+  for (int level = 1; level < _levelCount; ++level)
+  {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level - 1);
+    glFramebufferTexture2D(GL_FRAMEBUFFER,
+      GL_DEPTH_ATTACHMENT,
+      GL_TEXTURE_2D,
+      _depthTexture,
+      level);
+    glViewport(0, 0, std::max(1, _W >> level), std::max(1, _H >> level));
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+  }
+  glDepthFunc(GL_LESS);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, _levelCount - 1);
+}
+
+void
+OcclusionCuller::test(const std::vector<Candidate>& candidates,
+  const mat4f& vpMatrix)
+{
+  const auto n = int(candidates.size());
+
+  if (n == 0)
+    return;
+  _bounds.clear();
+  for (const auto& c : candidates)
+  {
+    _bounds.push_back(c.bounds.min());
+    _bounds.push_back(c.bounds.max());
+    _tested.push_back(c.primitive);
+  }
+
+  const auto rows = (n + resultWidth - 1) / resultWidth;
+
+  if (rows > _resultHeight)
+  {
+    _resultHeight = rows;
+    glBindTexture(GL_TEXTURE_2D, _resultTexture);
+    glTexImage2D(GL_TEXTURE_2D,
+      0,
+      GL_R8,
+      resultWidth,
+      rows,
+      0,
+      GL_RED,
+      GL_UNSIGNED_BYTE,
+      nullptr);
+    glBindFramebuffer(GL_FRAMEBUFFER, _resultFramebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER,
+      GL_COLOR_ATTACHMENT0,
+      GL_TEXTURE_2D,
+      _resultTexture,
+      0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, _pixelBuffer);
+    glBufferData(GL_PIXEL_PACK_BUFFER,
+      resultWidth * rows,
+      nullptr,
+      GL_STREAM_READ);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, _resultFramebuffer);
+  glViewport(0, 0, resultWidth, rows);
+  glDisable(GL_DEPTH_TEST);
+  glPointSize(1);
+  _testProgram.use();
+  _testProgram.setUniformMat4("vpMatrix", vpMatrix);
+  _testProgram.setUniform("levelCount", _levelCount);
+  _testProgram.setUniform("resultSize", float(resultWidth), float(rows));
+  glBindTexture(GL_TEXTURE_2D, _depthTexture);
+  glBindVertexArray(_boundsVAO);
+  _boundsBuffer.setData(_bounds.data(), _bounds.size() * sizeof(vec3f));
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 2 * sizeof(vec3f), 0);
+  glVertexAttribPointer(1,
+    3,
+    GL_FLOAT,
+    GL_FALSE,
+    2 * sizeof(vec3f),
+    (const void*)sizeof(vec3f));
+  glEnableVertexAttribArray(0);
+  glEnableVertexAttribArray(1);
+  glDrawArrays(GL_POINTS, 0, n);
+  glBindVertexArray(0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glEnable(GL_DEPTH_TEST);
+  // The results are read into the pixel buffer without waiting and
+  // mapped in the next frame
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, _pixelBuffer);
+  glReadPixels(0, 0, resultWidth, rows, GL_RED, GL_UNSIGNED_BYTE, 0);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void
+OcclusionCuller::cull(std::vector<Candidate>& candidates,
+  const mat4f& vpMatrix,
+  const vec3f& eye,
+  int width,
+  int height)
+{
+  if (_depthFramebuffer == 0)
+    initialize();
+
+  GLint framebuffer;
+  GLint viewport[4];
+  auto program = GLSL::Program::current();
+
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+  glGetIntegerv(GL_VIEWPORT, viewport);
+  readResults();
+  resize(width, height);
+  selectOccluders(candidates, eye);
+  drawOccluders(candidates, vpMatrix);
+  buildHiZ();
+  test(candidates, vpMatrix);
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+  GLSL::Program::setCurrent(program);
+  _stats.candidateCount = int(candidates.size());
+  _stats.occluderCount = int(_occluders.size());
+  // Drop the primitives found occluded in the previous frame
+  if (!_occluded.empty())
+    candidates.erase(std::remove_if(candidates.begin(),
+      candidates.end(),
+      [this](const Candidate& c)
+      {
+        return _occluded.find(c.primitive) != _occluded.end();
+      }),
+      candidates.end());
+  _stats.culledCount = _stats.candidateCount - int(candidates.size());
+}
+
+} // end namespace cg
@@ -0,0 +1,142 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: OcclusionCuller.h
+// ========
+// Class definition for Hi-Z occlusion culler.
+//
+// Author(s): Paulo Pagliosa, Carlos Monteiro e Yago Mescolotte
+// Last revision: 17/10/2026
+
+#ifndef __OcclusionCuller_h
+#define __OcclusionCuller_h
+
+#include "Primitive.h"
+#include "graphics/GLBuffer.h"
+#include <unordered_set>
+#include <vector>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// OcclusionCuller: Hi-Z occlusion culler class
+// ===============
+//
+// Culls the primitives hidden by the large ones in front of them. The
+// occluders are drawn into a depth buffer whose mip levels are reduced
+// to the farthest depth of the texels below them (Hi-Z). The bounds of
+// every primitive are then tested against the level where they cover
+// at most 2x2 texels, in a vertex shader writing one texel per
+// primitive, so that no compute shader is needed. The results are read
+// back asynchronously and applied in the next frame, so a primitive
+// may show up one frame late when it is disoccluded.
+class OcclusionCuller
+{
+public:
+  /// Primitive in the view frustum.
+  struct Candidate
+  {
+    Primitive* primitive;
+    TriangleMesh* mesh;
+    Bounds3f bounds;
+
+  }; // Candidate
+
+  struct Stats
+  {
+    int candidateCount;
+    int occluderCount;
+    int culledCount;
+
+  }; // Stats
+
+  // Number of results per row of the result texture
+  static constexpr int resultWidth = 256;
+
+  /// \brief Minimum angle, in radians, subtended by the bounding sphere
+  /// of an occluder as seen from the camera.
+  float occluderAngle{0.2f};
+  /// Maximum number of occluders drawn per frame.
+  int maxOccluders{64};
+
+  ~OcclusionCuller();
+
+  /// \brief Removes from \c candidates the primitives found occluded in
+  /// the previous frame and tests the remaining ones for the next frame.
+  /// The viewport is \c width x \c height and the eye is at \c eye.
+  void cull(std::vector<Candidate>& candidates,
+    const mat4f& vpMatrix,
+    const vec3f& eye,
+    int width,
+    int height);
+
+  /// Forgets the results of the previous frame.
+  void reset();
+
+  /// Returns the counts of the last cull.
+  const Stats& stats() const
+  {
+    return _stats;
+  }
+
+private:
+  GLSL::Program _depthProgram{"Hi-Z Depth"};
+  GLSL::Program _reduceProgram{"Hi-Z Reduce"};
+  GLSL::Program _testProgram{"Hi-Z Test"};
+  GLuint _depthTexture{};
+  GLuint _resultTexture{};
+  GLuint _depthFramebuffer{};
+  GLuint _resultFramebuffer{};
+  GLuint _pixelBuffer{};
+  GLuint _emptyVAO{};
+  GLuint _boundsVAO{};
+  GLBuffer _boundsBuffer{GL_ARRAY_BUFFER};
+  int _W{};
+  int _H{};
+  int _levelCount{};
+  int _resultHeight{};
+  std::vector<vec3f> _bounds;
+  // Angular size and index of the occluder candidates
+  std::vector<std::pair<float, int>> _occluders;
+  std::vector<const Primitive*> _tested;
+  std::unordered_set<const Primitive*> _occluded;
+  Stats _stats{};
+
+  void initialize();
+  void resize(int, int);
+  void readResults();
+  void selectOccluders(const std::vector<Candidate>&, const vec3f&);
+  void drawOccluders(const std::vector<Candidate>&, const mat4f&);
+  void buildHiZ();
+  void test(const std::vector<Candidate>&, const mat4f&);
+
+}; // OcclusionCuller
+
+} // end namespace cg
+
+#endif // __OcclusionCuller_h
@@ -6,7 +6,6 @@
 #include <iostream>
 
 #define MIN_SCALE				0.0001f
-#define FOCUS_OFFSET			10
 MeshMap P2::_defaultMeshes;
 
 inline void
@@ -165,10 +164,15 @@ void
 P2::initialize()
 {
   Application::loadShaders(_program, "shaders/p2.vs", "shaders/p2.fs");
+  Application::loadShaders(_instancedProgram,
+    "shaders/p2_instanced.vs",
+    "shaders/p2.fs");
+  _queue.addProgram(_program, &_instancedProgram);
   Assets::initialize();
   buildDefaultMeshes();
   buildScene();
   _renderer = new GLRenderer{*_sceneCurrent, &_program};
+  _renderer->setInstancedProgram(&_instancedProgram);
   glEnable(GL_DEPTH_TEST);
   glEnable(GL_POLYGON_OFFSET_FILL);
   glPolygonOffset(1.0f, 1.0f);
@@ -424,7 +428,7 @@ P2::inspectPrimitive(Primitive& primitive)
     if (auto* payload = ImGui::AcceptDragDropPayload("PrimitiveMesh"))
     {
       auto mit = *(MeshMapIterator*)payload->Data;
-      primitive.setMesh(mit->second, mit->first);
+      primitive.setMesh(Assets::loadMeshAsync(mit));
     }
     ImGui::EndDragDropTarget();
   }
@@ -439,7 +443,7 @@ P2::inspectPrimitive(Primitive& primitive)
     {
       for (auto mit = meshes.begin(); mit != meshes.end(); ++mit)
         if (ImGui::Selectable(mit->first.c_str()))
-          primitive.setMesh(Assets::loadMesh(mit), mit->first);
+          primitive.setMesh(Assets::loadMeshAsync(mit));
       ImGui::Separator();
     }
     for (auto mit = _defaultMeshes.begin(); mit != _defaultMeshes.end(); ++mit)
@@ -561,7 +565,7 @@ P2::sceneObjectGui()
 	for (auto component = begin; component != end; component++)
 	{
 
-		if (auto p = dynamic_cast<Primitive*>((*component).get()))
+		if (auto p = (*component)->as<Primitive>())
 		{
 			auto notDelete{ true };
 			auto open = ImGui::CollapsingHeader(p->typeName(), &notDelete);
@@ -574,7 +578,7 @@ P2::sceneObjectGui()
 			else if (open)
 				inspectPrimitive(*p);
 		}
-		else if (auto c = dynamic_cast<Camera*>((*component).get()))
+		else if (auto c = (*component)->as<Camera>())
 		{
 			auto notDelete{ true };
 			auto open = ImGui::CollapsingHeader(c->typeName(), &notDelete);
@@ -655,9 +659,16 @@ P2::assetsWindow()
       auto selected = false;
 
       ImGui::Selectable(meshName, &selected);
+      if (Assets::isLoading(mit))
+      {
+        ImGui::SameLine();
+        ImGui::TextDisabled("(loading)");
+      }
       if (ImGui::BeginDragDropSource())
       {
-        Assets::loadMesh(mit);
+        // Start loading the mesh while it is dragged
+        if (mit->second == nullptr)
+          Assets::loadMeshAsync(mit);
         ImGui::Text(meshName);
         ImGui::SetDragDropPayload("PrimitiveMesh", &mit, sizeof(mit));
         ImGui::EndDragDropSource();
@@ -682,6 +693,49 @@ P2::editorView()
   ImGui::End();
 }
 
+static void
+releaseGLMeshes(MeshMap& meshes)
+{
+  for (auto& m : meshes)
+    for (TriangleMesh* mesh = m.second; mesh != nullptr; mesh = mesh->lod)
+      mesh->userData = nullptr;
+}
+
+inline void
+P2::renderStatsWindow()
+{
+  if (!_showRenderStats || _viewMode != ViewMode::Renderer)
+    return;
+  ImGui::Begin("Render Stats", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+
+  auto culling = _renderer->occlusionCulling();
+
+  if (ImGui::Checkbox("Occlusion Culling", &culling))
+    _renderer->setOcclusionCulling(culling);
+
+  auto compact = GLMesh::compactByDefault();
+
+  if (ImGui::Checkbox("Compact Meshes", &compact))
+  {
+    // The GL meshes are created again, in the new format, when drawn
+    GLMesh::setCompactByDefault(compact);
+    releaseGLMeshes(Assets::meshes());
+    releaseGLMeshes(_defaultMeshes);
+  }
+  ImGui::Separator();
+
+  const auto& s = _renderer->stats();
+  const auto& q = _renderer->queueStats();
+
+  ImGui::Text("Primitives: %d", s.primitiveCount);
+  ImGui::Text("Frustum culled: %d", s.frustumCulledCount);
+  ImGui::Text("Occluders: %d", s.occluderCount);
+  ImGui::Text("Occlusion culled: %d", s.occlusionCulledCount);
+  ImGui::Text("Triangles: %d", s.triangleCount);
+  ImGui::Text("Draws: %d in %d draw calls", q.itemCount, q.drawCount);
+  ImGui::End();
+}
+
 inline void
 P2::fileMenu()
 {
@@ -775,10 +829,17 @@ P2::mainMenu()
       ImGui::Separator();
       ImGui::MenuItem("Assets Window", nullptr, &_showAssets);
       ImGui::MenuItem("Editor View Settings", nullptr, &_showEditorView);
+      ImGui::MenuItem("Render Stats", nullptr, &_showRenderStats);
       ImGui::EndMenu();
     }
     if (ImGui::BeginMenu("Tools"))
     {
+      auto enabled = Camera::current() != nullptr;
+
+      if (ImGui::MenuItem("Ray Trace Image", nullptr, false, enabled))
+        rayTraceScene();
+      if (ImGui::MenuItem("Rasterize Image", nullptr, false, enabled))
+        rasterizeScene();
       if (ImGui::BeginMenu("Options"))
       {
         showOptions();
@@ -798,6 +859,7 @@ P2::gui()
   inspectorWindow();
   assetsWindow();
   editorView();
+  renderStatsWindow();
 
   /*
   static bool demo = true;
@@ -805,35 +867,44 @@ P2::gui()
   */
 }
 
-inline void
-drawMesh(GLMesh* mesh, GLuint mode)
-{
-  glPolygonMode(GL_FRONT_AND_BACK, mode);
-  glDrawElements(GL_TRIANGLES, mesh->vertexCount(), GL_UNSIGNED_INT, 0);
-}
-
 inline void
 P2::drawPrimitive(Primitive& primitive)
 {
   auto m = glMesh(primitive.mesh());
 
   if (nullptr == m)
+  {
+    // Draw a bounding box proxy while the mesh is being loaded.
+    if (primitive.isLoading())
+    {
+      auto t = primitive.transform();
+
+      _editor->setLineColor(primitive.color);
+      _editor->drawBounds({Primitive::proxyBounds(), t->localToWorldMatrix()});
+    }
     return;
+  }
 
   auto t = primitive.transform();
-  auto normalMatrix = mat3f{t->worldToLocalMatrix()}.transposed();
-
-  _program.setUniformMat4("transform", t->localToWorldMatrix());
-  _program.setUniformMat3("normalMatrix", normalMatrix);
-  _program.setUniformVec4("color", primitive.color);
-  _program.setUniform("flatMode", (int)0);
-  m->bind();
-  drawMesh(m, GL_FILL);
+  const auto& eye = _editor->camera()->transform()->position();
+  auto depth = (t->position() - eye).squaredNorm();
+
+  // The level of detail is chosen by the size of the bounds on screen
+  {
+    const auto b = primitive.mesh()->bounds();
+    const auto& s = t->lossyScale();
+    auto d = b.diagonalLength() * std::max(std::abs(s.x),
+      std::max(std::abs(s.y), std::abs(s.z)));
+    auto z = (t->transform(b.center()) - eye).length();
+
+    m = glMesh(primitive.mesh()->levelOfDetail(
+      projectedSize(_editor->camera(), d, z, height())));
+  }
+
+  _queue.add(_program, *m, *t, primitive.color, GL_FILL, false, depth);
   if (primitive.sceneObject() != _current)
     return;
-  _program.setUniformVec4("color", _selectedWireframeColor);
-  _program.setUniform("flatMode", (int)1);
-  drawMesh(m, GL_LINE);
+  _queue.add(_program, *m, *t, _selectedWireframeColor, GL_LINE, true, depth);
 }
 
 inline void
@@ -895,14 +966,30 @@ P2::darkPreview(Camera& camera)
 
 void P2::focus() {
 	auto ob = dynamic_cast<SceneObject*>(_current);
-	auto T = ob->transform();
-	auto sc = T->localScale();
-	auto scMedia = (sc.x + sc.z + sc.y)/3;
-	auto lz = T->localPosition();
-	lz.z += FOCUS_OFFSET*scMedia;
-	_editor->camera()->transform()->setLocalPosition(lz);
-		
 
+	if (ob == nullptr)
+		return;
+
+	// Frame the bounds of the whole subtree of the object, or a unit box
+	// around it if there are no primitives in the subtree
+	auto b = ob->bounds();
+
+	if (b.min().x > b.max().x)
+	{
+		const auto& p = ob->transform()->position();
+
+		b.set(p - vec3f{1.0f}, p + vec3f{1.0f});
+	}
+
+	auto camera = _editor->camera();
+	auto t = camera->transform();
+	auto r = b.diagonalLength() * 0.5f;
+	auto d = 2 * r;
+
+	if (camera->projectionType() == Camera::Perspective)
+		d = r / (float)sin(camera->viewAngle() / 2 * M_PI / 180);
+	// The camera looks along the opposite of its forward direction
+	t->setPosition(b.center() + t->forward() * d);
 }
 
 
@@ -993,12 +1080,58 @@ P2::renderScene()
   }
 }
 
+// Renders scene from the current camera with an image renderer and
+// writes the image to <scene name><suffix>.png
+template <typename R>
+static void
+renderImage(Reference<R>& renderer,
+  Scene& scene,
+  int width,
+  int height,
+  const char* suffix)
+{
+  auto camera = Camera::current();
+
+  if (camera == nullptr)
+    return;
+  if (renderer == nullptr)
+    renderer = new R{scene, camera};
+  else
+  {
+    renderer->setScene(scene);
+    renderer->setCamera(camera);
+  }
+  renderer->setImageSize(width, height);
+  renderer->render();
+
+  auto filename = std::string{scene.name()} + suffix + ".png";
+
+  if (renderer->image()->writePNG(filename.c_str()))
+    printf("Image written to %s\n", filename.c_str());
+  else
+    printf("Unable to write %s\n", filename.c_str());
+}
+
+void
+P2::rayTraceScene()
+{
+  renderImage(_rayTracer, *_sceneCurrent, width(), height(), "");
+}
+
+void
+P2::rasterizeScene()
+{
+  renderImage(_rasterizer, *_sceneCurrent, width(), height(), "_raster");
+}
+
 constexpr auto CAMERA_RES = 0.01f;
 constexpr auto ZOOM_SCALE = 1.01f;
 
 void
 P2::render()
 {
+  Assets::update();
+  _sceneCurrent->bvh().update();
   if (_viewMode == ViewMode::Renderer)
   {
     renderScene();
@@ -1032,49 +1165,93 @@ P2::render()
 	auto object = _sceneCurrent->root();
 	auto begin = object->IteratorSceneObject();
 	auto end = object->IteratorEndSceneObject();
-	for (auto it = begin; it != end; it++) {
-		_program.setUniformMat4("vpMatrix", vp);
-		_program.setUniformVec4("ambientLight", _sceneCurrent->ambientLight);
-		_program.setUniformVec3("lightPosition", p);
-		renderRecursivo(*it);
-	}
+	Frustumf frustum{vp};
+
+	_queue.clear();
+	_previewCamera = nullptr;
+	for (auto it = begin; it != end; it++)
+		renderRecursivo(*it, frustum);
+	// Only the primitives in the view frustum of the editor camera are
+	// queued; whole BVH nodes out of it are rejected at once
+	auto& bvh = _sceneCurrent->bvh();
+
+	bvh.cull(frustum, [&](int i) { drawPrimitive(*bvh.primitive(i)); });
+	if (auto current = dynamic_cast<SceneObject*>(_current))
+		drawCurrent(*current);
+	_queue.setFrame(vp, _sceneCurrent->ambientLight, p);
+	_queue.submit();
+	_editor->flush();
+	// The preview of the current camera is drawn over the scene
+	if (_previewCamera != nullptr)
+		preview(*_previewCamera);
 }
 
 void
-P2::renderRecursivo(Reference<SceneObject>& object)
+P2::renderRecursivo(Reference<SceneObject>& object, const Frustumf& frustum)
 {
-	if (!object->visible)
+	// The primitives with a mesh are drawn from the scene BVH (see
+	// render()), so only the proxies of the meshes being loaded, and the
+	// primitives whose mesh BVH is being built, are left.
+	// Subtrees whose bounds are out of the frustum are skipped
+	if (!object->visible || !frustum.intersects(object->bounds()))
 		return;
 
 	auto beginS = object->IteratorSceneObject();
 	auto endS = object->IteratorEndSceneObject();
 	for (auto it = beginS; it != endS; it++)
-		renderRecursivo(*it);
+		renderRecursivo(*it, frustum);
 
-	Component* primitiveCurrent = nullptr;
-	auto begin = object->IteratorComponent();
-	auto end = object->IteratorEndComponent();
+	if (auto p = object->getComponent<Primitive>())
+		if (p->isLoading() || _sceneCurrent->bvh().isBuilding(p->mesh()))
+			drawPrimitive(*p);
+}
 
-	for (auto component = begin; component != end; component++)
+inline void
+P2::drawCurrent(SceneObject& object)
+{
+	// Objects in hidden subtrees have no gizmos
+	for (auto o = &object; o != nullptr; o = o->parent())
+		if (!o->visible)
+			return;
+
+	auto t = object.transform();
+
+	_editor->drawAxes(t->position(), mat3f{ t->rotation() });
+
+	if (auto c = object.getComponent<Camera>())
 	{
-		if (object == _current)
-		{
-			auto t = object->transform();
-			_editor->drawAxes(t->position(), mat3f{ t->rotation() });
-		}
-		if (auto p = dynamic_cast<Primitive*>((*component).get()))
-			drawPrimitive(*p);
-		
-		else if (auto c = dynamic_cast<Camera*>((*component).get()))
-			if (object == _current)
-			{
-				drawCamera(*c);
-				//darkPreview(*c);
-				preview(*c);
-			}
+		drawCamera(*c);
+		_previewCamera = c;
 	}
 }
 
+void
+P2::pick(int x, int y)
+{
+  // Objects may have been moved or deleted by the GUI since the last
+  // frame, so bring the scene BVH up to date first
+  auto& bvh = _sceneCurrent->bvh();
+
+  bvh.update();
+
+  // Unproject the cursor with the editor camera. The renderer camera
+  // is set again before rendering, so it is just restored afterwards
+  Reference<Camera> camera = _renderer->camera();
+
+  _renderer->setCamera(_editor->camera());
+  _renderer->setImageSize(width(), height());
+
+  // Window coordinates have their origin at the upper left corner
+  auto ray = _renderer->ray(x + 0.5f, height() - y - 0.5f);
+  SceneBVH::Hit hit;
+
+  _renderer->setCamera(camera);
+  if (bvh.intersect(ray, hit))
+    _current = hit.primitive->sceneObject();
+  else
+    _current = _sceneCurrent;
+}
+
 bool
 P2::windowResizeEvent(int width, int height)
 {
@@ -1138,7 +1315,17 @@ P2::mouseButtonInputEvent(int button, int actions, int mods)
 
   auto active = actions == GLFW_PRESS;
 
-	if (button == GLFW_MOUSE_BUTTON_RIGHT)
+	if (button == GLFW_MOUSE_BUTTON_LEFT)
+  {
+    if (active && !_dragFlags)
+    {
+      int x, y;
+
+      cursorPosition(x, y);
+      pick(x, y);
+    }
+  }
+  else if (button == GLFW_MOUSE_BUTTON_RIGHT)
     _dragFlags.enable(DragBits::Rotate, active);
   else if (button == GLFW_MOUSE_BUTTON_MIDDLE)
     _dragFlags.enable(DragBits::Pan, active);
@@ -7,6 +7,8 @@
 #include "Assets.h"
 #include "GLRenderer.h"
 #include "Primitive.h"
+#include "Rasterizer.h"
+#include "RayTracer.h"
 #include "SceneEditor.h"
 #include "core/Flags.h"
 #include "graphics/Application.h"
@@ -19,7 +21,8 @@ class P2: public GLWindow
 public:
   P2(int width, int height):
     GLWindow{"cg2019 - P2", width, height},
-    _program{"P2"}
+    _program{"P2"},
+    _instancedProgram{"P2 Instanced"}
   {
     // do nothing
   }
@@ -106,10 +109,15 @@ private:
 	bool _flagDeletePopup = false;
 
   GLSL::Program _program;
+  GLSL::Program _instancedProgram;
 	Scene* _sceneCurrent;
 	std::vector<Reference<Scene>> sceneColection;
   Reference<SceneEditor> _editor;
   Reference<GLRenderer> _renderer;
+  Reference<RayTracer> _rayTracer;
+  Reference<Rasterizer> _rasterizer;
+  RenderQueue _queue;
+  Camera* _previewCamera{};
   
 	SceneNode* _current{};
   Color _selectedWireframeColor{255, 102, 0};
@@ -122,15 +130,19 @@ private:
   int _mouseY;
   bool _showAssets{true};
   bool _showEditorView{true};
+  bool _showRenderStats{true};
   ViewMode _viewMode{ViewMode::Editor};
 
   static MeshMap _defaultMeshes;
 
   void buildScene();
   void renderScene();
+  void rayTraceScene();
+  void rasterizeScene();
 	void preview(Camera&);
 	void darkPreview(Camera&);
 	void focus();
+	void pick(int, int);
 
   void mainMenu();
   void fileMenu();
@@ -142,6 +154,7 @@ private:
   void inspectorWindow();
   void assetsWindow();
   void editorView();
+  void renderStatsWindow();
   void sceneGui();
   void sceneObjectGui();
   void objectGui();
@@ -152,6 +165,7 @@ private:
 
   void drawPrimitive(Primitive&);
   void drawCamera(Camera&);
+  void drawCurrent(SceneObject&);
 
   bool windowResizeEvent(int, int) override;
   bool keyInputEvent(int, int, int) override;
@@ -166,7 +180,7 @@ private:
 	Reference<SceneObject> nodeCreator(Reference<SceneObject>, objectType);
 
 	void hierarchyWindowRecursive(Reference<SceneObject>&);
-	void renderRecursivo(Reference<SceneObject>&);
+	void renderRecursivo(Reference<SceneObject>&, const Frustumf&);
 
 }; // P2
 
@@ -33,6 +33,7 @@
 #ifndef __Primitive_h
 #define __Primitive_h
 
+#include "Assets.h"
 #include "Component.h"
 #include "graphics/GLMesh.h"
 
@@ -47,21 +48,43 @@ namespace cg
 class Primitive: public Component
 {
 public:
+  static constexpr ComponentTypeId componentTypeId =
+    componentTypeIdOf<Primitive>();
+
   Color color{Color::white};
 
   Primitive(TriangleMesh* mesh, const std::string& meshName):
-    Component{"Primitive"},
+    Component{"Primitive", componentTypeId},
     _mesh{mesh},
     _meshName(meshName)
   {
     // do nothing
   }
 
+  /// Returns the mesh of this primitive, or null while it is loading.
   TriangleMesh* mesh() const
   {
+    if (_load != nullptr && _load->isReady())
+    {
+      _mesh = _load->mesh();
+      _load = nullptr;
+      meshChanged();
+    }
     return _mesh;
   }
 
+  /// Returns true if the mesh of this primitive is being loaded.
+  bool isLoading() const
+  {
+    return mesh() == nullptr && _load != nullptr;
+  }
+
+  /// Returns the bounds drawn in place of a mesh being loaded.
+  static Bounds3f proxyBounds()
+  {
+    return Bounds3f{vec3f{-1.0f}, vec3f{1.0f}};
+  }
+
   const char* const meshName() const
   {
     return _meshName.c_str();
@@ -71,11 +94,27 @@ public:
   {
     _mesh = mesh;
     _meshName = meshName;
+    _load = nullptr;
+    meshChanged();
+  }
+
+  /// Sets the mesh of this primitive to the one loaded by \c load.
+  void setMesh(MeshLoad* load)
+  {
+    if (load == nullptr)
+      return;
+    _mesh = nullptr;
+    _meshName = load->name();
+    _load = load;
+    meshChanged();
   }
 
 private:
-  Reference<TriangleMesh> _mesh;
+  mutable Reference<TriangleMesh> _mesh;
   std::string _meshName;
+  mutable MeshLoadRef _load;
+
+  void meshChanged() const; // implemented in SceneObject.h
 
 }; // Primitive
 
@@ -0,0 +1,587 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: Rasterizer.cpp
+// ========
+// Source file for CPU rasterizer.
+//
+// Author(s): Paulo Pagliosa, Carlos Monteiro e Yago Mescolotte
+// Last revision: 17/10/2026
+
+#include "Rasterizer.h"
+#include "math/SIMD.h"
+#include <algorithm>
+
+namespace cg
+{ // begin namespace cg
+
+namespace internal
+{ // begin namespace internal
+
+// Number of vertices or triangles processed by a task
+constexpr int chunkSize = 16384;
+
+inline int
+chunkCount(int n)
+{
+  return (n + chunkSize - 1) / chunkSize;
+}
+
+// Returns the planes of the view volume a point in clip space is out of
+inline int
+outcode(const vec4f& p)
+{
+  return int(p.x < -p.w) | int(p.x > p.w) << 1 |
+    int(p.y < -p.w) << 2 | int(p.y > p.w) << 3 |
+    int(p.z < -p.w) << 4 | int(p.z > p.w) << 5;
+}
+
+// Same lighting as p2.vs
+inline Color
+lighting(const Color& ambient,
+  const Color& color,
+  const vec3f& lightPosition,
+  const vec3f& P,
+  const vec3f& N)
+{
+  auto L = (lightPosition - P).versor();
+
+  return ambient + color * std::max(N.dot(L), 0.0f);
+}
+
+template <typename T>
+inline T
+lerp(const T& a, const T& b, float t)
+{
+  return a + (b - a) * t;
+}
+
+} // end namespace internal
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// Rasterizer implementation
+// ==========
+Rasterizer::Rasterizer(Scene& scene, Camera* camera, int threadCount):
+  Renderer{scene, camera},
+  _pool{threadCount}
+{
+  // do nothing
+}
+
+void
+Rasterizer::resize()
+{
+  if (_image != nullptr && _image->width() == _W && _image->height() == _H)
+    return;
+  _image = new Image{_W, _H};
+  // The depth buffer is padded to whole blocks
+  _stride = (_W + blockSize - 1) / blockSize * blockSize;
+
+  const auto height = (_H + blockSize - 1) / blockSize * blockSize;
+
+  _depth.resize(_stride * height);
+  _blockDepth.resize(_stride / blockSize * (height / blockSize));
+  _columns = (_W + tileSize - 1) / tileSize;
+  _rows = (_H + tileSize - 1) / tileSize;
+}
+
+inline void
+Rasterizer::project(Vertex& v) const
+{
+  const auto& p = v.position;
+  const auto w = 1 / p.w;
+
+  v.window.set((p.x * w + 1) * 0.5f * _W,
+    (p.y * w + 1) * 0.5f * _H,
+    (p.z * w + 1) * 0.5f,
+    w);
+}
+
+void
+Rasterizer::collect()
+{
+  auto& bvh = _sceneCurrent->bvh();
+
+  // Wait for the mesh BVHs being built, as the ray tracer does
+  bvh.update(true);
+
+  const auto vp = vpMatrix(_camera);
+  _instances.clear();
+  // Skip the primitives whose bounds are out of the view volume
+  bvh.cull(Frustumf{vp}, [&](int i)
+  {
+    const auto& b = bvh.primitiveBounds(i);
+    auto primitive = bvh.primitive(i);
+    auto mesh = bvh.mesh(i);
+    auto t = primitive->transform();
+    Instance instance;
+
+    instance.mesh = mesh;
+    instance.localToWorld = t->localToWorldMatrix();
+    instance.mvp = vp * instance.localToWorld;
+    instance.normalMatrix = mat3f{t->worldToLocalMatrix()}.transposed();
+    instance.color = primitive->color;
+    instance.distance = (b.center() - _lightPosition).squaredNorm();
+    _instances.push_back(instance);
+  });
+  // Near primitives are drawn first, so that the hierarchical Z
+  // rejects more of the far ones
+  std::stable_sort(_instances.begin(),
+    _instances.end(),
+    [](const Instance& a, const Instance& b)
+    {
+      return a.distance < b.distance;
+    });
+
+  int vertexCount{};
+  int triangleCount{};
+
+  for (auto& instance : _instances)
+  {
+    instance.firstVertex = vertexCount;
+    instance.firstTriangle = triangleCount;
+    vertexCount += instance.mesh->data().numberOfVertices;
+    triangleCount += instance.mesh->data().numberOfTriangles;
+  }
+  _vertices.resize(vertexCount);
+  _bins.resize(internal::chunkCount(triangleCount));
+}
+
+void
+Rasterizer::transformVertices(int chunk)
+{
+  const auto first = chunk * internal::chunkSize;
+  const auto last = std::min(first + internal::chunkSize,
+    int(_vertices.size()));
+  const auto& ambient = _sceneCurrent->ambientLight;
+  auto instance = std::upper_bound(_instances.begin(),
+    _instances.end(),
+    first,
+    [](int v, const Instance& i) { return v < i.firstVertex; }) - 1;
+
+  for (auto v = first; v < last; ++instance)
+  {
+    const auto& data = instance->mesh->data();
+    const auto end = std::min(last,
+      instance->firstVertex + data.numberOfVertices);
+
+    for (; v < end; ++v)
+    {
+      const auto i = v - instance->firstVertex;
+      const auto& p = data.vertices[i];
+      auto& vertex = _vertices[v];
+
+      vertex.position = instance->mvp * vec4f{p, 1};
+      project(vertex);
+      // Meshes with no normals are lit per face by setupTriangles()
+      if (data.vertexNormals != nullptr)
+        vertex.color = internal::lighting(ambient,
+          instance->color,
+          _lightPosition,
+          instance->localToWorld.transform3x4(p),
+          (instance->normalMatrix * data.vertexNormals[i]).versor());
+    }
+  }
+}
+
+void
+Rasterizer::setupTriangles(int chunk)
+{
+  const auto first = chunk * internal::chunkSize;
+  const auto triangleCount = _instances.empty() ? 0 :
+    _instances.back().firstTriangle +
+    _instances.back().mesh->data().numberOfTriangles;
+  const auto last = std::min(first + internal::chunkSize, triangleCount);
+  const auto& ambient = _sceneCurrent->ambientLight;
+  auto& bin = _bins[chunk];
+
+  bin.triangles.clear();
+  bin.tiles.resize(_columns * _rows);
+  for (auto& tile : bin.tiles)
+    tile.clear();
+
+  auto instance = std::upper_bound(_instances.begin(),
+    _instances.end(),
+    first,
+    [](int t, const Instance& i) { return t < i.firstTriangle; }) - 1;
+
+  for (auto t = first; t < last; ++instance)
+  {
+    const auto& data = instance->mesh->data();
+    const auto end = std::min(last,
+      instance->firstTriangle + data.numberOfTriangles);
+    const auto vertices = _vertices.data() + instance->firstVertex;
+
+    for (; t < end; ++t)
+    {
+      const auto& triangle = data.triangles[t - instance->firstTriangle];
+      const Vertex* v[3];
+      Vertex flat[3];
+
+      for (int k = 0; k < 3; ++k)
+        v[k] = vertices + triangle.v[k];
+      if (internal::outcode(v[0]->position) &
+        internal::outcode(v[1]->position) &
+        internal::outcode(v[2]->position))
+        continue;
+      if (data.vertexNormals == nullptr)
+      {
+        const auto& p0 = data.vertices[triangle.v[0]];
+        auto N = (data.vertices[triangle.v[1]] - p0).cross
+          (data.vertices[triangle.v[2]] - p0);
+
+        N = (instance->normalMatrix * N).versor();
+        for (int k = 0; k < 3; ++k)
+        {
+          auto P = data.vertices[triangle.v[k]];
+
+          P = instance->localToWorld.transform3x4(P);
+          flat[k].position = v[k]->position;
+          flat[k].window = v[k]->window;
+          flat[k].color = internal::lighting(ambient,
+            instance->color,
+            _lightPosition,
+            P,
+            N);
+          v[k] = flat + k;
+        }
+      }
+      if (v[0]->position.z < -v[0]->position.w ||
+        v[1]->position.z < -v[1]->position.w ||
+        v[2]->position.z < -v[2]->position.w)
+        clipTriangle(bin, v[0], v[1], v[2]);
+      else
+        setupTriangle(bin, v[0], v[1], v[2]);
+    }
+  }
+}
+
+void
+Rasterizer::clipTriangle(Bin& bin,
+  const Vertex* v0,
+  const Vertex* v1,
+  const Vertex* v2)
+{
+  // Clip against the near plane z = -w
+  const Vertex* v[]{v0, v1, v2};
+  Vertex polygon[4];
+  int n{};
+
+  for (int i = 0; i < 3; ++i)
+  {
+    const auto& a = *v[i];
+    const auto& b = *v[(i + 1) % 3];
+    auto da = a.position.z + a.position.w;
+    auto db = b.position.z + b.position.w;
+
+    if (da >= 0)
+      polygon[n++] = a;
+    if ((da >= 0) != (db >= 0))
+    {
+      auto t = da / (da - db);
+
+      polygon[n].position = internal::lerp(a.position, b.position, t);
+      polygon[n].color = internal::lerp(a.color, b.color, t);
+      project(polygon[n++]);
+    }
+  }
+  for (int i = 2; i < n; ++i)
+    setupTriangle(bin, polygon, polygon + i - 1, polygon + i);
+}
+
+void
+Rasterizer::setupTriangle(Bin& bin,
+  const Vertex* v0,
+  const Vertex* v1,
+  const Vertex* v2)
+{
+  const Vertex* v[]{v0, v1, v2};
+  float x[3];
+  float y[3];
+  vec3f z;
+  vec3f w;
+  vec3f color[3];
+
+  for (int i = 0; i < 3; ++i)
+  {
+    x[i] = v[i]->window.x;
+    y[i] = v[i]->window.y;
+  }
+
+  // Bounds of the covered pixel centers
+  auto x0 = std::max(0, int(std::ceil(std::min({x[0], x[1], x[2]}) - 0.5f)));
+  auto y0 = std::max(0, int(std::ceil(std::min({y[0], y[1], y[2]}) - 0.5f)));
+  auto x1 = std::min(_W - 1,
+    int(std::floor(std::max({x[0], x[1], x[2]}) - 0.5f)));
+  auto y1 = std::min(_H - 1,
+    int(std::floor(std::max({y[0], y[1], y[2]}) - 0.5f)));
+
+  if (x0 > x1 || y0 > y1)
+    return;
+
+  auto area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+
+  if (area == 0)
+    return;
+  for (int i = 0; i < 3; ++i)
+  {
+    z[i] = v[i]->window.z;
+    w[i] = v[i]->window.w;
+    for (int c = 0; c < 3; ++c)
+      color[c][i] = v[i]->color[c] * w[i];
+  }
+  // The planes are relative to the bounds origin, so that their
+  // constant terms stay small
+  for (int i = 0; i < 3; ++i)
+  {
+    x[i] -= x0;
+    y[i] -= y0;
+  }
+
+  // Both faces are drawn, as in the GL renderer; edges are
+  // counterclockwise
+  int i1 = 1;
+  int i2 = 2;
+
+  if (area < 0)
+  {
+    std::swap(i1, i2);
+    area = -area;
+  }
+
+  const int index[]{0, i1, i2};
+  const auto s = 1 / area;
+  Triangle triangle;
+
+  triangle.topLeft = 0;
+  for (int e = 0; e < 3; ++e)
+  {
+    // Edge from a to b, opposite to the vertex e
+    const auto a = index[(e + 1) % 3];
+    const auto b = index[(e + 2) % 3];
+    const auto dx = x[b] - x[a];
+    const auto dy = y[b] - y[a];
+
+    triangle.edges[index[e]].set((y[a] - y[b]) * s,
+      dx * s,
+      (x[a] * y[b] - y[a] * x[b]) * s);
+    if (dy < 0 || (dy == 0 && dx < 0))
+      triangle.topLeft |= 1 << index[e];
+  }
+
+  // Plane of an attribute with values f at the vertices
+  auto plane = [&triangle](const vec3f& f)
+  {
+    const auto* e = triangle.edges;
+
+    return vec3f{e[0].x * f[0] + e[1].x * f[1] + e[2].x * f[2],
+      e[0].y * f[0] + e[1].y * f[1] + e[2].y * f[2],
+      e[0].z * f[0] + e[1].z * f[1] + e[2].z * f[2]};
+  };
+
+  triangle.z = plane(z);
+  triangle.w = plane(w);
+  for (int c = 0; c < 3; ++c)
+    triangle.color[c] = plane(color[c]);
+  triangle.x0 = x0;
+  triangle.y0 = y0;
+  triangle.x1 = x1;
+  triangle.y1 = y1;
+  triangle.zMin = std::min({z[0], z[1], z[2]});
+
+  const auto id = int(bin.triangles.size());
+
+  bin.triangles.push_back(triangle);
+  for (auto ty = y0 / tileSize, ty1 = y1 / tileSize; ty <= ty1; ++ty)
+    for (auto tx = x0 / tileSize, tx1 = x1 / tileSize; tx <= tx1; ++tx)
+      bin.tiles[ty * _columns + tx].push_back(id);
+}
+
+void
+Rasterizer::rasterize(const Triangle& t, int x0, int y0, int x1, int y1)
+{
+  constexpr auto N = simd::width;
+  using vfloat = simd::vfloat<N>;
+  using vmask = simd::vmask<N>;
+
+  alignas(32) static const float laneOffsets[]
+  {
+    0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f
+  };
+  const auto offsets = vfloat::load(laneOffsets);
+  const auto blocksPerRow = _stride / blockSize;
+  // Pixels are relative to the triangle bounds origin
+  const vfloat xMin{float(x0 - t.x0)};
+  const vfloat xMax{float(x1 + 1 - t.x0)};
+  auto& image = *_image;
+
+  // Edge function e evaluated at (x, y)
+  auto eval = [](const vec3f& e, const vfloat& x, const vfloat& y)
+  {
+    return vfloat(e.x) * x + vfloat(e.y) * y + vfloat(e.z);
+  };
+  auto inside = [&t](int e, const vfloat& d) -> vmask
+  {
+    return t.topLeft >> e & 1 ? d >= vfloat(0.0f) : d > vfloat(0.0f);
+  };
+
+  for (auto by = y0 / blockSize * blockSize; by <= y1; by += blockSize)
+    for (auto bx = x0 / blockSize * blockSize; bx <= x1; bx += blockSize)
+    {
+      auto& blockDepth = _blockDepth[by / blockSize * blocksPerRow +
+        bx / blockSize];
+
+      // Hierarchical Z: the triangle is behind every pixel of the block
+      if (t.zMin >= blockDepth)
+        continue;
+
+      auto written = false;
+
+      for (auto y = std::max(by, y0), ye = std::min(by + blockSize - 1, y1);
+        y <= ye;
+        ++y)
+      {
+        const vfloat py{y - t.y0 + 0.5f};
+
+        for (auto x = bx; x < bx + blockSize; x += N)
+        {
+          if (x > x1 || x + N <= x0)
+            continue;
+
+          const auto px = vfloat(float(x - t.x0)) + offsets;
+          auto mask = (px > xMin) & (px < xMax) &
+            inside(0, eval(t.edges[0], px, py)) &
+            inside(1, eval(t.edges[1], px, py)) &
+            inside(2, eval(t.edges[2], px, py));
+
+          if (mask.bits() == 0)
+            continue;
+
+          auto depth = _depth.data() + y * _stride + x;
+          auto d = vfloat::loadu(depth);
+          auto z = eval(t.z, px, py);
+
+          mask = mask & (z < d);
+
+          const auto bits = mask.bits();
+
+          if (bits == 0)
+            continue;
+          select(mask, z, d).storeu(depth);
+          written = true;
+
+          // Perspective correct color
+          const auto w = vfloat(1.0f) / eval(t.w, px, py);
+          alignas(32) float color[3][N];
+
+          for (int c = 0; c < 3; ++c)
+            (eval(t.color[c], px, py) * w).store(color[c]);
+          for (int i = 0; i < N; ++i)
+            if (bits >> i & 1)
+              image(x + i, y) = Color{color[0][i], color[1][i], color[2][i]};
+        }
+      }
+      if (written)
+      {
+        auto block = _depth.data() + by * _stride + bx;
+        auto m = vfloat::loadu(block);
+
+        for (int y = 0; y < blockSize; ++y, block += _stride)
+          for (int x = 0; x < blockSize; x += N)
+            m = max(m, vfloat::loadu(block + x));
+
+        auto z = m[0];
+
+        for (int i = 1; i < N; ++i)
+          z = std::max(z, m[i]);
+        blockDepth = z;
+      }
+    }
+}
+
+void
+Rasterizer::rasterizeTile(int tile)
+{
+  const auto x0 = tile % _columns * tileSize;
+  const auto y0 = tile / _columns * tileSize;
+  const auto x1 = std::min(x0 + tileSize, _W) - 1;
+  const auto y1 = std::min(y0 + tileSize, _H) - 1;
+  const auto& bc = _sceneCurrent->backgroundColor;
+  auto& image = *_image;
+
+  // Clear the tile, including the padding of the depth buffer
+  {
+    const auto xe = std::min(x0 + tileSize, _stride);
+    const auto ye = std::min(y0 + tileSize,
+      int(_depth.size()) / _stride);
+    const auto blocksPerRow = _stride / blockSize;
+
+    for (auto y = y0; y < ye; ++y)
+      std::fill(_depth.begin() + y * _stride + x0,
+        _depth.begin() + y * _stride + xe,
+        1.0f);
+    for (auto y = y0; y < ye; y += blockSize)
+      std::fill(_blockDepth.begin() + y / blockSize * blocksPerRow +
+        x0 / blockSize,
+        _blockDepth.begin() + y / blockSize * blocksPerRow +
+        xe / blockSize,
+        1.0f);
+    for (auto y = y0; y <= y1; ++y)
+      for (auto x = x0; x <= x1; ++x)
+        image(x, y) = bc;
+  }
+  // Triangles are drawn in submission order
+  for (const auto& bin : _bins)
+    for (auto i : bin.tiles[tile])
+    {
+      const auto& t = bin.triangles[i];
+
+      rasterize(t,
+        std::max(t.x0, x0),
+        std::max(t.y0, y0),
+        std::min(t.x1, x1),
+        std::min(t.y1, y1));
+    }
+}
+
+void
+Rasterizer::render()
+{
+  if (_W <= 0 || _H <= 0)
+    return;
+  resize();
+  _lightPosition = _camera->transform()->position();
+  collect();
+  _pool.run(internal::chunkCount(int(_vertices.size())),
+    [this](int chunk) { transformVertices(chunk); });
+  _pool.run(int(_bins.size()),
+    [this](int chunk) { setupTriangles(chunk); });
+  _pool.run(_columns * _rows,
+    [this](int tile) { rasterizeTile(tile); });
+}
+
+} // end namespace cg
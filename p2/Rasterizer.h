@@ -0,0 +1,158 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: Rasterizer.h
+// ========
+// Class definition for CPU rasterizer.
+//
+// Author(s): Paulo Pagliosa, Carlos Monteiro e Yago Mescolotte
+// Last revision: 17/10/2026
+
+#ifndef __Rasterizer_h
+#define __Rasterizer_h
+
+#include "Renderer.h"
+#include "graphics/Image.h"
+#include "utils/ThreadPool.h"
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// Rasterizer: CPU rasterizer class
+// ==========
+//
+// Renders a scene into in-memory color and depth buffers with the
+// same vertex lighting as p2.vs, without a GL context. Rendering runs
+// in three passes on a work-stealing thread pool: vertices are lit and
+// transformed to clip space; triangles are clipped against the near
+// plane, set up and binned into screen tiles; and each tile is cleared
+// and rasterized in submission order, so the image does not depend on
+// the number of threads. Coverage and depth are evaluated on a row of
+// SIMD lanes at a time, and a per-block maximum depth (hierarchical Z)
+// rejects blocks hidden by the triangles already drawn.
+class Rasterizer: public Renderer
+{
+public:
+  static constexpr int tileSize = 64;
+  static constexpr int blockSize = 8;
+
+  /// \brief Constructs a rasterizer rendering on \c threadCount threads,
+  /// or as many as the hardware threads if \c threadCount <= 0.
+  Rasterizer(Scene& scene, Camera* camera = nullptr, int threadCount = 0);
+
+  /// Returns the color buffer of the last render.
+  const Image* image() const
+  {
+    return _image;
+  }
+
+  /// \brief Returns the depth of the pixel (x, y), in [0, 1], of the
+  /// last render.
+  float depth(int x, int y) const
+  {
+    return _depth[y * _stride + x];
+  }
+
+  void render() override;
+
+private:
+  struct Instance
+  {
+    const TriangleMesh* mesh;
+    mat4f localToWorld;
+    mat4f mvp;
+    mat3f normalMatrix;
+    Color color;
+    float distance;
+    int firstVertex;
+    int firstTriangle;
+
+  }; // Instance
+
+  // Lit vertex in clip space, with its window coordinates x, y, z
+  // and 1/w
+  struct Vertex
+  {
+    vec4f position;
+    vec4f window;
+    Color color;
+
+  }; // Vertex
+
+  // Triangle in window coordinates. The edge functions are scaled by
+  // the inverse of the area, giving the barycentric coordinates of a
+  // point, and z, 1/w and color/w are interpolated by their planes.
+  // Both are relative to the origin (x0, y0) of the pixel bounds.
+  struct Triangle
+  {
+    vec3f edges[3];
+    vec3f z;
+    vec3f w;
+    vec3f color[3];
+    int x0, y0, x1, y1;
+    float zMin;
+    int topLeft;
+
+  }; // Triangle
+
+  // Triangles set up by a task, with the indices of the ones
+  // overlapping each tile
+  struct Bin
+  {
+    std::vector<Triangle> triangles;
+    std::vector<std::vector<int>> tiles;
+
+  }; // Bin
+
+  ThreadPool _pool;
+  Reference<Image> _image;
+  std::vector<float> _depth;
+  std::vector<float> _blockDepth;
+  int _stride{};
+  int _columns{};
+  int _rows{};
+  std::vector<Instance> _instances;
+  std::vector<Vertex> _vertices;
+  std::vector<Bin> _bins;
+  vec3f _lightPosition;
+
+  void resize();
+  void project(Vertex&) const;
+  void collect();
+  void transformVertices(int);
+  void setupTriangles(int);
+  void setupTriangle(Bin&, const Vertex*, const Vertex*, const Vertex*);
+  void clipTriangle(Bin&, const Vertex*, const Vertex*, const Vertex*);
+  void rasterizeTile(int);
+  void rasterize(const Triangle&, int, int, int, int);
+
+}; // Rasterizer
+
+} // end namespace cg
+
+#endif // __Rasterizer_h
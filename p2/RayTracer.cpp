@@ -0,0 +1,135 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: RayTracer.cpp
+// ========
+// Source file for CPU ray tracer.
+//
+// Author(s): Paulo Pagliosa, Carlos Monteiro e Yago Mescolotte
+// Last revision: 17/10/2026
+
+#include "RayTracer.h"
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// RayTracer implementation
+// =========
+RayTracer::RayTracer(Scene& scene, Camera* camera, int threadCount):
+  Renderer{scene, camera},
+  _pool{threadCount}
+{
+  // do nothing
+}
+
+inline Ray
+RayTracer::pixelRay(float x, float y) const
+{
+  // Same as Renderer::ray(), with the inverse matrix computed once
+  auto unproject = [this](float x, float y, float z)
+  {
+    auto p = _inverseVPMatrix * vec4f{x / _W * 2 - 1, y / _H * 2 - 1, z, 1};
+    return vec3f{p} * math::inverse(p.w);
+  };
+  auto p = unproject(x, y, -1);
+
+  return Ray{p, unproject(x, y, 1) - p};
+}
+
+Color
+RayTracer::shade(const Ray& ray) const
+{
+  SceneBVH::Hit hit;
+
+  if (!_sceneCurrent->bvh().intersect(ray, hit))
+    return _sceneCurrent->backgroundColor;
+
+  const auto& data = hit.mesh->data();
+  const auto& triangle = data.triangles[hit.triangleIndex];
+  vec3f N;
+
+  if (data.vertexNormals == nullptr)
+  {
+    const auto& p0 = data.vertices[triangle.v[0]];
+
+    N = (data.vertices[triangle.v[1]] - p0).cross
+      (data.vertices[triangle.v[2]] - p0);
+  }
+  else
+    N = triangle::interpolate(hit.p,
+      data.vertexNormals[triangle.v[0]],
+      data.vertexNormals[triangle.v[1]],
+      data.vertexNormals[triangle.v[2]]);
+
+  auto primitive = hit.primitive;
+  auto t = primitive->transform();
+
+  N = (mat3f{t->worldToLocalMatrix()}.transposed() * N).versor();
+
+  auto L = (_lightPosition - ray(hit.distance)).versor();
+
+  return _sceneCurrent->ambientLight +
+    primitive->color * std::max(N.dot(L), 0.0f);
+}
+
+void
+RayTracer::renderTile(int tile)
+{
+  const auto columns = (_W + tileSize - 1) / tileSize;
+  const auto x0 = tile % columns * tileSize;
+  const auto y0 = tile / columns * tileSize;
+  const auto x1 = std::min(x0 + tileSize, _W);
+  const auto y1 = std::min(y0 + tileSize, _H);
+  auto& image = *_image;
+
+  for (auto y = y0; y < y1; ++y)
+    for (auto x = x0; x < x1; ++x)
+      image(x, y) = shade(pixelRay(x + 0.5f, y + 0.5f));
+}
+
+void
+RayTracer::render()
+{
+  if (_W <= 0 || _H <= 0)
+    return;
+  if (_image == nullptr || _image->width() != _W || _image->height() != _H)
+    _image = new Image{_W, _H};
+  // The image must have every primitive, even the ones with a mesh BVH
+  // still being built
+  _sceneCurrent->bvh().update(true);
+  _inverseVPMatrix = vpMatrix(_camera);
+  _inverseVPMatrix.invert();
+  _lightPosition = _camera->transform()->position();
+
+  const auto columns = (_W + tileSize - 1) / tileSize;
+  const auto rows = (_H + tileSize - 1) / tileSize;
+
+  _pool.run(columns * rows, [this](int tile) { renderTile(tile); });
+}
+
+} // end namespace cg
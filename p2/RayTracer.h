@@ -0,0 +1,85 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: RayTracer.h
+// ========
+// Class definition for CPU ray tracer.
+//
+// Author(s): Paulo Pagliosa, Carlos Monteiro e Yago Mescolotte
+// Last revision: 17/10/2026
+
+#ifndef __RayTracer_h
+#define __RayTracer_h
+
+#include "Renderer.h"
+#include "graphics/Image.h"
+#include "utils/ThreadPool.h"
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// RayTracer: CPU ray tracer class
+// =========
+//
+// Renders a scene into an in-memory image with the same lighting as
+// the GL renderer, i.e., ambient light plus Lambertian reflection of a
+// point light at the camera position. The image is split into tiles
+// distributed over a work-stealing thread pool, and rays are traced
+// through the scene BVH. It needs no GL context.
+class RayTracer: public Renderer
+{
+public:
+  static constexpr int tileSize = 32;
+
+  /// \brief Constructs a ray tracer rendering on \c threadCount threads,
+  /// or as many as the hardware threads if \c threadCount <= 0.
+  RayTracer(Scene& scene, Camera* camera = nullptr, int threadCount = 0);
+
+  /// Returns the image of the last render.
+  const Image* image() const
+  {
+    return _image;
+  }
+
+  void render() override;
+
+private:
+  ThreadPool _pool;
+  Reference<Image> _image;
+  mat4f _inverseVPMatrix;
+  vec3f _lightPosition;
+
+  Ray pixelRay(float x, float y) const;
+  Color shade(const Ray&) const;
+  void renderTile(int);
+
+}; // RayTracer
+
+} // end namespace cg
+
+#endif // __RayTracer_h
@@ -0,0 +1,318 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: RenderQueue.cpp
+// ========
+// Source file for render queue.
+//
+// Author(s): Paulo Pagliosa, Carlos Monteiro e Yago Mescolotte
+// Last revision: 17/10/2026
+
+#include "RenderQueue.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// RenderQueue implementation
+// ===========
+void
+RenderQueue::addProgram(GLSL::Program& program, GLSL::Program* instanced)
+{
+  GLint flatModeLocation{-1};
+
+  program.setUniformBlockBinding("FrameBlock", frameBinding);
+  program.setUniformBlockBinding("ObjectBlock", objectBinding);
+  if (instanced != nullptr)
+  {
+    instanced->setUniformBlockBinding("FrameBlock", frameBinding);
+    flatModeLocation = instanced->uniformLocation("flatMode");
+  }
+  for (auto& p : _instanced)
+    if (p.program == &program)
+    {
+      p.instanced = instanced;
+      p.flatModeLocation = flatModeLocation;
+      return;
+    }
+  _instanced.push_back({&program, instanced, flatModeLocation});
+}
+
+const RenderQueue::InstancedProgram*
+RenderQueue::instancedProgram(GLSL::Program* program) const
+{
+  for (const auto& p : _instanced)
+    if (p.program == program)
+      return &p;
+  return nullptr;
+}
+
+void
+RenderQueue::setFrame(const mat4f& vpMatrix,
+  const Color& ambientLight,
+  const vec3f& lightPosition)
+{
+  FrameBlock frame{vpMatrix, ambientLight, vec4f{lightPosition, 1}};
+
+  _frameBuffer.setData(&frame, sizeof frame);
+}
+
+void
+RenderQueue::add(GLSL::Program& program,
+  GLMesh& mesh,
+  const Transform& transform,
+  const Color& color,
+  GLenum polygonMode,
+  bool flat,
+  float depth)
+{
+  // Key bits: program (8), VAO (24), polygon mode (1), depth (31). The
+  // bits of a non-negative float sort as the float does
+  uint32_t d;
+
+  depth = std::max(depth, 0.0f);
+  memcpy(&d, &depth, sizeof d);
+
+  Item item;
+
+  item.key = uint64_t(GLuint(program) & 0xff) << 56 |
+    uint64_t(mesh.vao() & 0xffffff) << 32 |
+    uint64_t(polygonMode == GL_LINE) << 31 |
+    d;
+  item.program = &program;
+  item.mesh = &mesh;
+  item.transform = &transform;
+  item.color = color;
+  item.polygonMode = polygonMode;
+  item.flatMode = flat;
+  _items.push_back(item);
+}
+
+void
+RenderQueue::collectRuns()
+{
+  auto sameState = [](const Item& a, const Item& b)
+  {
+    return a.program == b.program && a.mesh == b.mesh &&
+      a.polygonMode == b.polygonMode && a.flatMode == b.flatMode;
+  };
+
+  _runs.clear();
+  _objects.clear();
+  _instances.clear();
+  for (size_t i = 0, n = _items.size(); i < n;)
+  {
+    auto end = i + 1;
+
+    while (end < n && sameState(_items[end], _items[i]))
+      ++end;
+
+    Run run{i, end, nullptr, -1, 0};
+
+    if (end - i >= minInstances)
+      if (auto p = instancedProgram(_items[i].program))
+      {
+        run.instanced = p->instanced;
+        run.flatModeLocation = p->flatModeLocation;
+      }
+    if (run.instanced != nullptr)
+    {
+      run.first = _instances.size();
+      for (; i < end; ++i)
+      {
+        const auto& item = _items[i];
+        const auto t = item.transform;
+
+        _instances.push_back({t->localToWorldMatrix() *
+            item.mesh->positionMatrix(),
+          mat3f{t->worldToLocalMatrix()}.transposed(),
+          item.color});
+      }
+    }
+    else
+    {
+      run.first = _objects.size() / _objectStride;
+      _objects.resize(_objects.size() + (end - i) * _objectStride);
+      for (auto p = _objects.data() + run.first * _objectStride;
+        i < end;
+        ++i, p += _objectStride)
+      {
+        const auto& item = _items[i];
+        const auto t = item.transform;
+        const auto n = mat3f{t->worldToLocalMatrix()}.transposed();
+        auto object = reinterpret_cast<ObjectBlock*>(p);
+
+        object->transform = t->localToWorldMatrix() *
+          item.mesh->positionMatrix();
+        for (int c = 0; c < 3; ++c)
+          object->normalMatrix[c] = vec4f{n[c], 0};
+        object->color = item.color;
+        object->flatMode = item.flatMode;
+      }
+    }
+    _runs.push_back(run);
+  }
+}
+
+void
+RenderQueue::drawInstanced(const Run& run)
+{
+  // Attributes 2-5: transform, 6-8: normal matrix, 9: color. They are
+  // set on the mesh VAO, which is bound, at each draw, since the VAO
+  // may be drawn by other queues
+  const auto base = run.first * sizeof(Instance);
+  auto& calls = _stats.callCount;
+  auto attribute = [base, &calls](GLuint location,
+    GLint size,
+    size_t offset)
+  {
+    glVertexAttribPointer(location,
+      size,
+      GL_FLOAT,
+      GL_FALSE,
+      GLsizei(sizeof(Instance)),
+      (const void*)(base + offset));
+    glVertexAttribDivisor(location, 1);
+    glEnableVertexAttribArray(location);
+    calls += 3;
+  };
+
+  _instanceBuffer.bind();
+  ++calls;
+  for (GLuint i = 0; i < 4; ++i)
+    attribute(2 + i, 4, offsetof(Instance, transform) + i * sizeof(vec4f));
+  for (GLuint i = 0; i < 3; ++i)
+    attribute(6 + i, 3, offsetof(Instance, normalMatrix) + i * sizeof(vec3f));
+  attribute(9, 4, offsetof(Instance, color));
+
+  const auto& item = _items[run.begin];
+
+  glDrawElementsInstanced(GL_TRIANGLES,
+    item.mesh->vertexCount(),
+    item.mesh->indexType(),
+    0,
+    GLsizei(run.end - run.begin));
+  ++calls;
+}
+
+void
+RenderQueue::submit()
+{
+  std::sort(_items.begin(), _items.end(), [](const Item& a, const Item& b)
+  {
+    return a.key < b.key;
+  });
+  _stats = {};
+  if (_objectStride == 0)
+  {
+    auto alignment = size_t(GLBuffer::uniformOffsetAlignment());
+
+    _objectStride = (sizeof(ObjectBlock) + alignment - 1) / alignment *
+      alignment;
+  }
+  collectRuns();
+
+  auto& calls = _stats.callCount;
+
+  // Object blocks and instances of all draws
+  if (!_objects.empty())
+  {
+    _objectBuffer.setData(_objects.data(), _objects.size());
+    calls += 3;
+  }
+  if (!_instances.empty())
+  {
+    _instanceBuffer.setData(_instances.data(),
+      _instances.size() * sizeof(Instance));
+    calls += 3;
+  }
+  _frameBuffer.bindRange(frameBinding, 0, sizeof(FrameBlock));
+  ++calls;
+
+  auto previous = GLSL::Program::current();
+  GLSL::Program* program{};
+  GLMesh* mesh{};
+  GLenum polygonMode{};
+
+  for (const auto& run : _runs)
+  {
+    const auto& first = _items[run.begin];
+    auto p = run.instanced != nullptr ? run.instanced : first.program;
+
+    if (p != program)
+    {
+      program = p;
+      program->use();
+      ++calls;
+    }
+    if (first.mesh != mesh)
+    {
+      mesh = first.mesh;
+      mesh->bind();
+      ++calls;
+    }
+    if (first.polygonMode != polygonMode)
+    {
+      polygonMode = first.polygonMode;
+      glPolygonMode(GL_FRONT_AND_BACK, polygonMode);
+      ++calls;
+    }
+    ++_stats.drawCount;
+    if (run.instanced != nullptr)
+    {
+      GLSL::Program::setUniform(run.flatModeLocation, first.flatMode);
+      ++calls;
+      drawInstanced(run);
+      continue;
+    }
+    _stats.drawCount += int(run.end - run.begin) - 1;
+    for (auto i = run.begin; i < run.end; ++i)
+    {
+      _objectBuffer.bindRange(objectBinding,
+        (run.first + i - run.begin) * _objectStride,
+        sizeof(ObjectBlock));
+      glDrawElements(GL_TRIANGLES,
+        mesh->vertexCount(),
+        mesh->indexType(),
+        0);
+      calls += 2;
+    }
+  }
+  if (polygonMode == GL_LINE)
+  {
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    ++calls;
+  }
+  if (previous != nullptr && previous != program)
+    previous->use();
+  _stats.itemCount = int(_items.size());
+}
+
+} // end namespace cg
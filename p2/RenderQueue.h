@@ -0,0 +1,199 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: RenderQueue.h
+// ========
+// Class definition for render queue.
+//
+// Author(s): Paulo Pagliosa, Carlos Monteiro e Yago Mescolotte
+// Last revision: 17/10/2026
+
+#ifndef __RenderQueue_h
+#define __RenderQueue_h
+
+#include "Transform.h"
+#include "graphics/GLBuffer.h"
+#include "graphics/GLMesh.h"
+#include <cstdint>
+#include <vector>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// RenderQueue: render queue class
+// ===========
+//
+// Collects the draws of a frame into a flat array, sorts them by
+// program, mesh VAO, polygon mode and depth, and submits them setting
+// only the GL state that changed between consecutive draws. Runs of
+// draws of the same mesh with a program that has an instanced variant
+// are submitted as a single instanced draw, with the transforms,
+// normal matrices and colors in an instance buffer. The programs must
+// have the uniform blocks of p2.vs, and the instanced ones the frame
+// block and attributes of p2_instanced.vs. The object blocks of all
+// draws, as well as the instance data, are uploaded once per submit.
+class RenderQueue
+{
+public:
+  static constexpr int minInstances = 2;
+  // Binding points of the uniform blocks
+  static constexpr GLuint frameBinding = 0;
+  static constexpr GLuint objectBinding = 1;
+
+  struct Stats
+  {
+    int drawCount;
+    int itemCount;
+    int callCount;
+
+  }; // Stats
+
+  /// \brief Adds a program and its instanced variant, if not null, to
+  /// this queue, binding their uniform blocks.
+  void addProgram(GLSL::Program& program, GLSL::Program* instanced = nullptr);
+
+  /// Sets the per-frame uniform block of the draws of this queue.
+  void setFrame(const mat4f& vpMatrix,
+    const Color& ambientLight,
+    const vec3f& lightPosition);
+
+  /// Removes all draws of this queue.
+  void clear()
+  {
+    _items.clear();
+  }
+
+  /// Returns the number of draws in this queue.
+  auto size() const
+  {
+    return _items.size();
+  }
+
+  /// \brief Adds a draw of \c mesh with \c transform and \c color. Draws
+  /// with the same state are submitted in increasing \c depth, e.g., the
+  /// squared distance to the camera, so that near meshes are drawn first.
+  void add(GLSL::Program& program,
+    GLMesh& mesh,
+    const Transform& transform,
+    const Color& color,
+    GLenum polygonMode,
+    bool flat,
+    float depth);
+
+  /// Sorts and submits the draws of this queue.
+  void submit();
+
+  /// \brief Returns the number of draw calls, draws submitted by them
+  /// and GL calls of the last submit.
+  const Stats& stats() const
+  {
+    return _stats;
+  }
+
+private:
+  struct Item
+  {
+    uint64_t key;
+    GLSL::Program* program;
+    GLMesh* mesh;
+    const Transform* transform;
+    Color color;
+    GLenum polygonMode;
+    int flatMode;
+
+  }; // Item
+
+  // Uniform blocks, in std140 layout
+  struct FrameBlock
+  {
+    mat4f vpMatrix;
+    Color ambientLight;
+    vec4f lightPosition;
+
+  }; // FrameBlock
+
+  struct ObjectBlock
+  {
+    mat4f transform;
+    vec4f normalMatrix[3];
+    Color color;
+    int flatMode;
+    int padding[3];
+
+  }; // ObjectBlock
+
+  struct Instance
+  {
+    mat4f transform;
+    mat3f normalMatrix;
+    Color color;
+
+  }; // Instance
+
+  // A program, its instanced variant and the location of the flatMode
+  // uniform of the latter
+  struct InstancedProgram
+  {
+    GLSL::Program* program;
+    GLSL::Program* instanced;
+    GLint flatModeLocation;
+
+  }; // InstancedProgram
+
+  // Draws with the same state. The first object block or instance of
+  // the run is first
+  struct Run
+  {
+    size_t begin;
+    size_t end;
+    GLSL::Program* instanced;
+    GLint flatModeLocation;
+    size_t first;
+
+  }; // Run
+
+  std::vector<Item> _items;
+  std::vector<InstancedProgram> _instanced;
+  std::vector<Run> _runs;
+  std::vector<char> _objects;
+  std::vector<Instance> _instances;
+  GLBuffer _frameBuffer{GL_UNIFORM_BUFFER};
+  GLBuffer _objectBuffer{GL_UNIFORM_BUFFER};
+  GLBuffer _instanceBuffer{GL_ARRAY_BUFFER};
+  size_t _objectStride{};
+  Stats _stats{};
+
+  const InstancedProgram* instancedProgram(GLSL::Program*) const;
+  void collectRuns();
+  void drawInstanced(const Run&);
+
+}; // RenderQueue
+
+} // end namespace cg
+
+#endif // __RenderQueue_h
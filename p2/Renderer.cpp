@@ -100,4 +100,14 @@ Renderer::unproject(const vec3f& w) const
   return normalize(m * p);
 }
 
+Ray
+Renderer::ray(float x, float y) const
+{
+  // Unproject the point onto the near and far planes, which works for
+  // both perspective and parallel projections
+  auto p = unproject({x, y, 0});
+
+  return Ray{p, unproject({x, y, 1}) - p};
+}
+
 } // end namespace cg
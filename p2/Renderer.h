@@ -75,6 +75,10 @@ public:
   vec3f project(const vec3f&) const;
   vec3f unproject(const vec3f&) const;
 
+  /// \brief Returns the ray from the camera through the point (x, y) of
+  /// the image, with origin at the lower left corner.
+  Ray ray(float x, float y) const;
+
   virtual void update();
   virtual void render() = 0;
 
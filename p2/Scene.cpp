@@ -0,0 +1,200 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: Scene.cpp
+// ========
+// Source file for scene.
+//
+// Author(s): Paulo Pagliosa, Carlos Monteiro e Yago Mescolotte
+// Last revision: 17/10/2026
+
+#include "Scene.h"
+#include <algorithm>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// Scene implementation
+// =====
+// The world data of all transforms are computed by level, with SIMD,
+// when at least 1/sweepRatio of them are dirty
+static constexpr int sweepRatio = 4;
+// Levels are split in chunks of at least minChunkSize slots, about
+// chunksPerThread per thread, computed in parallel
+static constexpr int minChunkSize = 4096;
+static constexpr int chunksPerThread = 4;
+
+inline void
+Scene::markDirty(Transform* t)
+{
+  t->_store->_dirty[t->_index] = t->_store->_changed[t->_index] = 1;
+  t->sceneObject()->invalidateBounds();
+  ++_dirtyCount;
+}
+
+void
+Scene::markDirty(SceneObject* object)
+{
+  // The subtree of a dirty transform is dirty already
+  if (object->transform()->_store->_dirty[object->transform()->_index])
+    return;
+  markDirty(object->transform());
+
+  auto end = object->IteratorEndSceneObject();
+
+  for (auto it = object->IteratorSceneObject(); it != end; ++it)
+    markDirty(*it);
+}
+
+void
+Scene::flatten(SceneObject* object, int depth)
+{
+  auto t = object->transform();
+
+  t->_first = int(_transforms.size());
+  _transforms.push_back(t);
+  _depths.push_back(depth);
+
+  auto end = object->IteratorEndSceneObject();
+
+  for (auto it = object->IteratorSceneObject(); it != end; ++it)
+    flatten(*it, depth + 1);
+  t->_end = int(_transforms.size());
+}
+
+void
+Scene::sortTransforms()
+{
+  // Counting sort of the slots by depth
+  const auto n = int(_transforms.size());
+  std::vector<int> order(n);
+
+  _levels.assign(*std::max_element(_depths.begin(), _depths.end()) + 2, 0);
+  for (auto d : _depths)
+    ++_levels[d + 1];
+  for (size_t d = 1; d < _levels.size(); ++d)
+    _levels[d] += _levels[d - 1];
+  {
+    auto next = _levels;
+
+    for (int i = 0; i < n; ++i)
+      order[next[_depths[i]]++] = _transforms[i]->_index;
+  }
+  _transformStore->reorder(order);
+  for (auto t : _transforms)
+  {
+    auto p = t->parent();
+
+    _transformStore->setParent(t->_index, p != nullptr ? p->_index : -1);
+  }
+}
+
+void
+Scene::updateLevel(int first, int last)
+{
+  // The slots of a level depend only on the ones of the previous levels,
+  // and each one is computed by the same arithmetic whatever the chunk
+  // holding it, so the results do not depend on the partition
+  const auto n = last - first;
+
+  if (n < 2 * minChunkSize || _threadCount == 1)
+  {
+    _transformStore->updateLevel(first, last);
+    return;
+  }
+  if (_pool == nullptr)
+    _pool.reset(new ThreadPool{_threadCount});
+
+  const auto m = std::min(n / minChunkSize, _pool->size() * chunksPerThread);
+  // Chunk sizes are rounded up to a multiple of 64 slots, so that few
+  // cache lines of the flag arrays are shared by the threads
+  const auto size = (n / m + 63) & ~63;
+
+  _pool->run((n + size - 1) / size, [&](int chunk)
+  {
+    auto begin = first + chunk * size;
+
+    _transformStore->updateLevel(begin, std::min(begin + size, last));
+  });
+}
+
+void
+Scene::invalidateTransform(Transform* t)
+{
+  // While the hierarchy is unchanged, the descendants of a transform
+  // follow it in the flattened hierarchy. Dirty subtrees are skipped
+  if (!_hierarchyChanged && t->_first >= 0 && _transforms[t->_first] == t)
+    for (auto i = t->_first; i < t->_end;)
+    {
+      auto d = _transforms[i];
+
+      if (d->_store->_dirty[d->_index])
+        i = d->_end;
+      else
+      {
+        markDirty(d);
+        ++i;
+      }
+    }
+  else
+    markDirty(t->sceneObject());
+  _dirtyTransforms.push_back(t);
+}
+
+void
+Scene::updateTransforms()
+{
+  // The dirty transforms may have been destroyed with the objects
+  // removed from the hierarchy, so all transforms are computed then
+  auto sweep = _hierarchyChanged;
+
+  if (_hierarchyChanged)
+  {
+    _transforms.clear();
+    _depths.clear();
+    flatten(&_root, 0);
+    sortTransforms();
+    _hierarchyChanged = false;
+  }
+  if (sweep || _dirtyCount * sweepRatio >= int(_transforms.size()))
+  {
+    // The slots of a level follow the ones of their parents
+    _root.transform()->validate();
+    for (size_t l = 2; l < _levels.size(); ++l)
+      updateLevel(_levels[l - 1], _levels[l]);
+  }
+  else
+    for (auto t : _dirtyTransforms)
+      if (t->_first >= 0 && _transforms[t->_first] == t)
+        for (auto i = t->_first; i < t->_end; ++i)
+          _transforms[i]->validate();
+  _dirtyTransforms.clear();
+  _dirtyCount = 0;
+}
+
+} // end namespace cg
@@ -33,8 +33,11 @@
 #ifndef __Scene_h
 #define __Scene_h
 
-#include "SceneObject.h"
+#include "SceneBVH.h"
 #include "graphics/Color.h"
+#include "utils/ThreadPool.h"
+#include <memory>
+#include <vector>
 
 namespace cg
 { // begin namespace cg
@@ -53,9 +56,13 @@ public:
   /// Constructs an empty scene.
   Scene(const char* name):
     SceneNode{name},
-    _root{"\0x1bRoot", *this}
+    _transformStore{new TransformStore},
+    _componentStore{new ComponentStore},
+    _root{"\0x1bRoot", *this},
+    _bvh{*this}
   {
     SceneObject::makeUse(&_root);
+    _root._attached = true;
   }
 
   /// Returns the root scene object of this scene.
@@ -69,8 +76,84 @@ public:
     return &_root;
   }
 
+  /// Returns the BVH of this scene (see SceneBVH::update()).
+  const SceneBVH& bvh() const
+  {
+    return _bvh;
+  }
+
+  SceneBVH& bvh()
+  {
+    return _bvh;
+  }
+
+  /// \brief Returns the components of type T of the scene objects of
+  /// this scene, in no particular order (see ComponentStore).
+  template <typename T>
+  const ComponentArray<T>& components() const
+  {
+    return _componentStore->components<T>();
+  }
+
+  /// \brief Computes the world data of the dirty transforms of this
+  /// scene, parent before child. Called once per frame by
+  /// SceneBVH::update().
+  void updateTransforms();
+
+  /// \brief Returns the number of threads computing the levels of the
+  /// hierarchy in updateTransforms(), or 0 if as many as the hardware
+  /// threads.
+  int threadCount() const
+  {
+    return _threadCount;
+  }
+
+  /// Sets the number of threads computing the levels of the hierarchy.
+  void setThreadCount(int threadCount)
+  {
+    if (threadCount != _threadCount)
+    {
+      _threadCount = threadCount;
+      _pool.reset();
+    }
+  }
+
 private:
+  // Declared first, so that they are destroyed after the scene objects
+  Reference<TransformStore> _transformStore;
+  Reference<ComponentStore> _componentStore;
   SceneObject _root;
+  SceneBVH _bvh;
+  // Transforms of the scene objects in depth-first order, flattened
+  // again when the hierarchy changes
+  std::vector<Transform*> _transforms;
+  std::vector<int> _depths;
+  // First slot of each level of the hierarchy in the transform store,
+  // and the end of the last one
+  std::vector<int> _levels;
+  // Transforms made dirty, with their descendants, since the last update
+  std::vector<Transform*> _dirtyTransforms;
+  int _dirtyCount{};
+  bool _hierarchyChanged{true};
+  // Created on the first level large enough to be split
+  std::unique_ptr<ThreadPool> _pool;
+  int _threadCount{};
+
+  void markDirty(Transform*);
+  void markDirty(SceneObject*);
+
+  void flatten(SceneObject*, int);
+  void sortTransforms();
+  void updateLevel(int, int);
+  void invalidateTransform(Transform*);
+
+  void hierarchyChanged()
+  {
+    _hierarchyChanged = true;
+  }
+
+  friend class SceneObject;
+  friend class Transform;
 
 }; // Scene
 
@@ -0,0 +1,344 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: SceneBVH.cpp
+// ========
+// Source file for scene BVH.
+//
+// Author(s): Paulo Pagliosa, Carlos Monteiro e Yago Mescolotte
+// Last revision: 17/10/2026
+
+#include "Scene.h"
+#include <unordered_set>
+
+namespace cg
+{ // begin namespace cg
+
+inline Bounds3f
+worldBounds(const TriangleMesh& mesh, const Transform& t)
+{
+  return Bounds3f{mesh.bounds(), t.localToWorldMatrix()};
+}
+
+inline bool
+operator ==(const Bounds3f& a, const Bounds3f& b)
+{
+  return a.min() == b.min() && a.max() == b.max();
+}
+
+inline void
+inflate(Bounds3f& b, const BVHBase::Node& c1, const BVHBase::Node& c2)
+{
+  b.setEmpty();
+  b.inflate(c1.bounds);
+  b.inflate(c2.bounds);
+}
+
+// The camera of a scene object consumes the changed flag of its
+// transform when updating its view, so the flag is kept for it
+inline void
+consumeChange(SceneObject* object)
+{
+  if (!object->hasComponent<Camera>())
+    object->transform()->setChanged(false);
+}
+
+// Objects in hidden subtrees are not visible
+inline bool
+isVisible(const SceneObject* object)
+{
+  for (; object != nullptr; object = object->parent())
+    if (!object->visible)
+      return false;
+  return true;
+}
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// SceneBVH implementation
+// ========
+// Number of primitives per leaf of the top-level BVH
+static constexpr int maxPrimitivesPerLeaf = 2;
+// Refit degrades the tree as objects move apart; rebuild it when the
+// area of the root grows past this factor
+static constexpr float maxAreaGrowth = 2;
+// BVHs of meshes with more triangles than this are built in background,
+// so that no frame stalls on them
+static constexpr int maxSyncBuildTriangles = 8192;
+
+bool
+SceneBVH::hasMeshBVH(TriangleMesh& mesh, bool wait)
+{
+  if (_meshBVHs.find(&mesh) != _meshBVHs.end())
+    return true;
+  if (wait || mesh.data().numberOfTriangles <= maxSyncBuildTriangles)
+  {
+    _meshBVHs.emplace(&mesh, new BVH{mesh});
+    return true;
+  }
+  if (_meshBuilds.find(&mesh) == _meshBuilds.end())
+  {
+    // The mesh is kept alive by the task until its BVH references it
+    Reference<TriangleMesh> m{&mesh};
+
+    _meshBuilds.emplace(&mesh, std::async(std::launch::async,
+      [m]() { return new BVH{*m}; }));
+  }
+  return false;
+}
+
+void
+SceneBVH::finishMeshBuilds(bool wait)
+{
+  using namespace std::chrono_literals;
+
+  // Waiting, the builds in background are finished before any mesh BVH
+  // is built in this thread, so that no mesh is built twice
+  for (auto it = _meshBuilds.begin(); it != _meshBuilds.end();)
+    if (!wait && it->second.wait_for(0s) != std::future_status::ready)
+      ++it;
+    else
+    {
+      _meshBVHs.emplace(it->first, it->second.get());
+      it = _meshBuilds.erase(it);
+    }
+}
+
+inline void
+SceneBVH::visit(SceneObject* object, Primitive* primitive, TriangleMesh* mesh)
+{
+  auto k = _visited.size();
+
+  // Compare the visited primitives against the ones of the last update
+  // and look for their transform changes in the same pass
+  if (!_rebuild)
+  {
+    if (k < _instances.size() && _instances[k].primitive.get() == primitive &&
+      _instances[k].mesh == mesh)
+    {
+      if (object->transform()->changed())
+        _changed.push_back(int(k));
+    }
+    else
+      _rebuild = true;
+  }
+  _visited.push_back({object, primitive, mesh});
+}
+
+void
+SceneBVH::collect(bool wait)
+{
+  // The primitives are visited in the order of the primitive array of
+  // the scene, which changes only when primitives are added or removed,
+  // with no traversal of the hierarchy
+  for (auto primitive : _scene->components<Primitive>())
+    // Primitives with a mesh being loaded are left out
+    if (auto mesh = primitive->mesh())
+    {
+      auto object = primitive->sceneObject();
+
+      // So are the ones whose mesh BVH is being built, unless waiting
+      if (isVisible(object) && hasMeshBVH(*mesh, wait))
+        visit(object, primitive, mesh);
+    }
+}
+
+void
+SceneBVH::update(bool waitForBuilds)
+{
+  _scene->updateTransforms();
+  finishMeshBuilds(waitForBuilds);
+  _visited.clear();
+  _changed.clear();
+  collect(waitForBuilds);
+  if (_visited.size() != _instances.size())
+    _rebuild = true;
+  if (_rebuild || refit())
+  {
+    const auto n = _visited.size();
+
+    _instances.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      const auto& v = _visited[i];
+
+      _instances[i] = {v.object, v.primitive, v.mesh};
+    }
+    rebuild();
+    _rebuild = false;
+  }
+}
+
+void
+SceneBVH::rebuild()
+{
+  const auto n = int(_instances.size());
+  std::unordered_set<const TriangleMesh*> meshes;
+
+  _bounds.resize(n);
+  for (int i = 0; i < n; ++i)
+  {
+    const auto& instance = _instances[i];
+
+    _bounds[i] = worldBounds(*instance.mesh, *instance.object->transform());
+    consumeChange(instance.object);
+    meshes.insert(instance.mesh);
+  }
+  build(_bounds, maxPrimitivesPerLeaf);
+  _builtArea = bounds().area();
+
+  // Map primitives to leaves and nodes to parents for refitting
+  const auto nodeCount = int(_nodes.size());
+
+  _parents.assign(nodeCount, -1);
+  _leaves.resize(n);
+  for (int i = 0; i < nodeCount; ++i)
+  {
+    const auto& node = _nodes[i];
+
+    if (!node.isLeaf())
+      _parents[i + 1] = _parents[node.first] = i;
+    else
+      for (int k = 0; k < node.count; ++k)
+        _leaves[_primitiveIds[node.first + k]] = i;
+  }
+
+  // Release the BVHs of meshes no longer in the scene. The ones of the
+  // meshes entering it were built by collect()
+  for (auto it = _meshBVHs.begin(); it != _meshBVHs.end();)
+    if (meshes.find(it->first) == meshes.end())
+      it = _meshBVHs.erase(it);
+    else
+      ++it;
+}
+
+void
+SceneBVH::refitLeaf(int node)
+{
+  auto& leaf = _nodes[node];
+
+  leaf.bounds.setEmpty();
+  for (int k = 0; k < leaf.count; ++k)
+    leaf.bounds.inflate(_bounds[_primitiveIds[leaf.first + k]]);
+  // Refit the ancestors until one whose bounds do not change
+  for (auto p = _parents[node]; p >= 0; p = _parents[p])
+  {
+    Bounds3f b;
+
+    inflate(b, _nodes[p + 1], _nodes[_nodes[p].first]);
+    if (b == _nodes[p].bounds)
+      break;
+    _nodes[p].bounds = b;
+  }
+}
+
+bool
+SceneBVH::refit()
+{
+  if (_changed.empty())
+    return false;
+  for (auto i : _changed)
+  {
+    const auto& instance = _instances[i];
+
+    _bounds[i] = worldBounds(*instance.mesh, *instance.object->transform());
+    consumeChange(instance.object);
+  }
+  if (_changed.size() <= _instances.size() / 8)
+    for (auto i : _changed)
+      refitLeaf(_leaves[i]);
+  else
+    // Many primitives moved: refit all nodes bottom-up, children first
+    for (auto i = int(_nodes.size()) - 1; i >= 0; --i)
+    {
+      auto& node = _nodes[i];
+
+      if (!node.isLeaf())
+        inflate(node.bounds, _nodes[i + 1], _nodes[node.first]);
+      else
+      {
+        node.bounds.setEmpty();
+        for (int k = 0; k < node.count; ++k)
+          node.bounds.inflate(_bounds[_primitiveIds[node.first + k]]);
+      }
+    }
+  return bounds().area() > _builtArea * maxAreaGrowth;
+}
+
+template <bool anyHit>
+bool
+SceneBVH::intersect(const Ray& ray, Hit& hit) const
+{
+  bool found = false;
+  auto stop = traverse(ray, [&](int i, float& tMax)
+  {
+    const auto& instance = _instances[i];
+    const auto& m = instance.object->transform()->worldToLocalMatrix();
+    Ray r;
+
+    // The local direction is not normalized, so that distances along
+    // the local ray are the same as along the world one
+    r.origin = m.transform3x4(ray.origin);
+    r.direction = m.transformVector(ray.direction);
+    r.tMin = ray.tMin;
+    r.tMax = tMax;
+
+    auto bvh = meshBVH(*instance.mesh);
+
+    if (anyHit)
+      return bvh->intersect(r);
+
+    BVH::Hit h;
+
+    if (bvh->intersect(r, h))
+    {
+      hit.primitive = instance.primitive;
+      hit.mesh = instance.mesh;
+      hit.triangleIndex = h.triangleIndex;
+      hit.p = h.p;
+      hit.distance = tMax = h.distance;
+      found = true;
+    }
+    return false;
+  });
+
+  return anyHit ? stop : found;
+}
+
+bool
+SceneBVH::intersect(const Ray& ray, Hit& hit) const
+{
+  return intersect<false>(ray, hit);
+}
+
+bool
+SceneBVH::intersect(const Ray& ray) const
+{
+  Hit hit;
+  return intersect<true>(ray, hit);
+}
+
+} // end namespace cg
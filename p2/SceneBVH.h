@@ -0,0 +1,195 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: SceneBVH.h
+// ========
+// Class definition for scene BVH.
+//
+// Author(s): Paulo Pagliosa, Carlos Monteiro e Yago Mescolotte
+// Last revision: 17/10/2026
+
+#ifndef __SceneBVH_h
+#define __SceneBVH_h
+
+#include "SceneObject.h"
+#include "geometry/BVH.h"
+#include "geometry/Frustum.h"
+#include <future>
+#include <unordered_map>
+
+namespace cg
+{ // begin namespace cg
+
+class Scene;
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// SceneBVH: scene bounding volume hierarchy class
+// ========
+//
+// Two-level BVH of a scene. The top level is built over the world
+// bounds of the visible primitives; each primitive is an instance of
+// the bottom-level BVH of its mesh, transformed by the local to world
+// matrix of the primitive. Mesh BVHs are built when their meshes enter
+// the scene, so that no query pays for them, and are shared by all
+// primitives using the same mesh. The BVHs of large meshes are built in
+// background; their primitives are left out of the hierarchy until
+// then.
+class SceneBVH final: public BVHBase
+{
+public:
+  /// Intersection record.
+  struct Hit
+  {
+    Primitive* primitive;
+    const TriangleMesh* mesh;
+    int triangleIndex;
+    /// Barycentric coordinates of the hit point.
+    vec3f p;
+    /// Distance of the hit point along the ray in world space.
+    float distance;
+
+  }; // Hit
+
+  SceneBVH(Scene& scene):
+    _scene{&scene}
+  {
+    // do nothing
+  }
+
+  /// \brief Updates this BVH. The hierarchy is rebuilt if primitives
+  /// were added, removed or hidden, or if their meshes changed; else,
+  /// only the nodes of the primitives whose transforms changed are refit.
+  /// Unless \c waitForBuilds is true, as when rendering an image, the
+  /// primitives whose mesh BVHs are being built in background are left
+  /// out (see isBuilding()), so that the editor does not stall on them.
+  void update(bool waitForBuilds = false);
+
+  /// Returns the number of primitives in this BVH.
+  auto size() const
+  {
+    return _instances.size();
+  }
+
+  /// Returns the primitive \c i of this BVH.
+  Primitive* primitive(int i) const
+  {
+    return _instances[i].primitive;
+  }
+
+  /// Returns the mesh of the primitive \c i of this BVH.
+  TriangleMesh* mesh(int i) const
+  {
+    return _instances[i].mesh;
+  }
+
+  /// Returns the world bounds of the primitive \c i of this BVH.
+  const Bounds3f& primitiveBounds(int i) const
+  {
+    return _bounds[i];
+  }
+
+  /// \brief Returns true if \c ray intersects a primitive. In this case,
+  /// \c hit is the closest intersection.
+  bool intersect(const Ray& ray, Hit& hit) const;
+
+  /// Returns true if \c ray intersects any primitive.
+  bool intersect(const Ray& ray) const;
+
+  /// \brief Visits the primitives whose world bounds intersect \c frustum.
+  /// The visitor is called as f(i), where \c i is the primitive index.
+  /// Nodes out of the frustum are rejected with all their primitives.
+  template <typename Visitor>
+  void cull(const Frustumf& frustum, Visitor f) const
+  {
+    traverse([&frustum](const Bounds3f& b) { return frustum.intersects(b); },
+      [&](int i)
+      {
+        if (frustum.intersects(_bounds[i]))
+          f(i);
+      });
+  }
+
+  /// \brief Returns the BVH of \c mesh, or null if it is not built.
+  /// The BVHs of the meshes in the scene are built by update(), so
+  /// queries can run concurrently.
+  BVH* meshBVH(const TriangleMesh& mesh) const
+  {
+    auto it = _meshBVHs.find(&mesh);
+    return it != _meshBVHs.end() ? it->second.get() : nullptr;
+  }
+
+  /// \brief Returns true if the BVH of \c mesh is being built. The
+  /// primitives of the mesh are not in this BVH meanwhile.
+  bool isBuilding(const TriangleMesh* mesh) const
+  {
+    return _meshBuilds.find(mesh) != _meshBuilds.end();
+  }
+
+private:
+  struct Visit
+  {
+    SceneObject* object;
+    Primitive* primitive;
+    TriangleMesh* mesh;
+
+  }; // Visit
+
+  struct Instance
+  {
+    Reference<SceneObject> object;
+    Reference<Primitive> primitive;
+    TriangleMesh* mesh;
+
+  }; // Instance
+
+  Scene* _scene;
+  std::vector<Instance> _instances;
+  std::vector<Visit> _visited;
+  bool _rebuild{true};
+  std::vector<Bounds3f> _bounds;
+  std::vector<int> _parents;
+  std::vector<int> _leaves;
+  std::vector<int> _changed;
+  float _builtArea;
+  std::unordered_map<const TriangleMesh*, Reference<BVH>> _meshBVHs;
+  std::unordered_map<const TriangleMesh*, std::future<BVH*>> _meshBuilds;
+
+  bool hasMeshBVH(TriangleMesh&, bool wait);
+  void finishMeshBuilds(bool wait);
+  void collect(bool wait);
+  void visit(SceneObject*, Primitive*, TriangleMesh*);
+  void rebuild();
+  bool refit();
+  void refitLeaf(int);
+
+  template <bool anyHit> bool intersect(const Ray&, Hit&) const;
+
+}; // SceneBVH
+
+} // end namespace cg
+
+#endif // __SceneBVH_h
@@ -36,11 +36,39 @@
 namespace cg
 { // begin namespace cg
 
+// Returns true if b has no point. Bounds3::empty() is also true for
+// flat bounds, as the ones of a plane
+inline bool
+isNull(const Bounds3f& b)
+{
+  return b.min().x > b.max().x;
+}
+
 
 /////////////////////////////////////////////////////////////////////
 //
 // SceneObject implementation
 // ===========
+SceneObject::SceneObject(const char* name, Scene& scene):
+  SceneNode{name},
+  _sceneCurrent{&scene},
+  _parent{},
+  _store{scene._componentStore},
+  _entity{_store->createEntity()}
+{
+  // The transform data are held by the transform store of the scene
+  _transform = new Transform(*scene._transformStore);
+  addComponent(makeUse(_transform));
+}
+
+SceneObject::~SceneObject()
+{
+  // Children kept alive elsewhere must not point to this scene object
+  for (auto& child : sceneObjectColection)
+    child->_parent = nullptr;
+  _store->destroyEntity(_entity);
+}
+
 void
 SceneObject::setParent(SceneObject* parent)
 {
@@ -50,12 +78,12 @@ SceneObject::setParent(SceneObject* parent)
 		(*this).scene()->root()->removeSceneObject(this);
 	}
 	else {
-		this->parent()->sceneObjectColection.remove(this);
+		this->parent()->removeSceneObject(this);
 	}
 
 	// Set new parent
 	this->_parent = parent;
-	this->transform()->update();
+	this->transform()->invalidate();
 
 	// Add this SceneObject in parent list
 	if (parent == nullptr) {
@@ -67,4 +95,54 @@ SceneObject::setParent(SceneObject* parent)
 	SceneObject::release(this);
 }
 
+void
+SceneObject::hierarchyChanged()
+{
+  _sceneCurrent->hierarchyChanged();
+}
+
+void
+SceneObject::setAttached(bool attached)
+{
+  // The components of a subtree leaving the hierarchy are removed from
+  // the component store, so that the systems of the scene, which iterate
+  // over the store, ignore them, and are stored again when it returns
+  if (_attached == attached)
+    return;
+  _attached = attached;
+  for (auto& component : componentColection)
+    if (attached)
+      storeComponent(component);
+    else
+      unstoreComponent(component->typeId());
+  for (auto& child : sceneObjectColection)
+    child->setAttached(attached);
+}
+
+const Bounds3f&
+SceneObject::bounds() const
+{
+  if (!_invalidBounds)
+    return _bounds;
+  _bounds.setEmpty();
+  if (auto primitive = getComponent<Primitive>())
+  {
+    const auto& m = _transform->localToWorldMatrix();
+
+    // A mesh being loaded is bounded by the proxy drawn in its place
+    if (auto mesh = primitive->mesh())
+    {
+      if (!isNull(mesh->bounds()))
+        _bounds.inflate(Bounds3f{mesh->bounds(), m});
+    }
+    else if (primitive->isLoading())
+      _bounds.inflate(Bounds3f{Primitive::proxyBounds(), m});
+  }
+  for (auto& child : sceneObjectColection)
+    if (!isNull(child->bounds()))
+      _bounds.inflate(child->bounds());
+  _invalidBounds = false;
+  return _bounds;
+}
+
 } // end namespace cg
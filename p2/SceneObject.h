@@ -37,7 +37,9 @@
 #include "Transform.h"
 #include "Primitive.h"
 #include "Camera.h"
+#include "ComponentStore.h"
 
+#include <cassert>
 #include <list>
 #include <vector>
 #include <iterator> 
@@ -59,14 +61,10 @@ public:
   bool visible{true};
 
   /// Constructs an empty scene object.
-  SceneObject(const char* name, Scene& scene):
-    SceneNode{name},
-    _sceneCurrent{&scene},
-    _parent{}
-  {
-		_transform = new Transform();
-		addComponent(makeUse(_transform));    
-  }
+  SceneObject(const char* name, Scene& scene); // implemented in SceneObject.cpp
+
+  /// Destructor.
+  ~SceneObject();
 
   /// Returns the scene which this scene object belong to.
   auto scene() const {
@@ -85,6 +83,14 @@ public:
 		this->_parent = parent;
 	}
 
+  /// \brief Returns true if this scene object is in the hierarchy of its
+  /// scene. Only the components of the scene objects in the hierarchy
+  /// are in the component store of the scene.
+  bool isAttached() const
+  {
+    return _attached;
+  }
+
   /// Returns the transform of this scene object.
   auto transform() const {
     return _transform;
@@ -94,6 +100,19 @@ public:
     return _transform;
   }
 
+  /// \brief Returns the world bounds of the primitives of this scene
+  /// object and its descendants, recomputed if they were invalidated.
+  /// Hidden objects are included, so that showing them needs no update.
+  const Bounds3f& bounds() const;
+
+  /// Invalidates the bounds of this scene object and its ancestors.
+  void invalidateBounds()
+  {
+    // The ancestors of an invalid scene object are invalid as well
+    for (auto o = this; o != nullptr && !o->_invalidBounds; o = o->_parent)
+      o->_invalidBounds = true;
+  }
+
 	// COMPONENT VECTOR
  	auto IteratorComponent() {
 		return componentColection.begin();
@@ -103,53 +122,73 @@ public:
 		return componentColection.end();
 	}
 
-	void addComponent(Component* component)
-	{
-		auto begin = this->componentColection.begin();
-		auto end = this->componentColection.end();
-
-		if (auto c = dynamic_cast<Transform*>(component))
-		{
-			for (auto comp = begin; comp != end; comp++)
-			{
-				if (auto p = dynamic_cast<Transform*>((*comp).get()))
-					return;
-			}
-		}
-		else if (auto c = dynamic_cast<Primitive*>(component))
-		{
-			for (auto comp = begin; comp != end; comp++)
-			{
-				if (auto p = dynamic_cast<Primitive*>((*comp).get()))
-					return;
-			}
-		}
-		else if (auto c = dynamic_cast<Camera*>(component))
-		{
-			for (auto comp = begin; comp != end; comp++)
-			{
-				if (auto p = dynamic_cast<Camera*>((*comp).get()))
-					return;
-			}
-		}
-		else
-			return;
-		component->_sceneObject = this;
-		componentColection.push_back(Component::makeUse(component));
-	}
+  /// Returns true if this scene object has a component of type T.
+  template <typename T>
+  bool hasComponent() const
+  {
+    return (_componentMask & componentMask<T>()) != 0;
+  }
 
-	void removeComponent(Reference<Component> component)
-	{
-		auto begin = componentColection.begin();
-		auto end = componentColection.end();
-		for (auto it = begin; it != end; it++)
-		{
-			if (*it == component) {
-				componentColection.erase(it);
-				break;
-			}
-		}
-	}
+  /// \brief Returns the component of type T of this scene object, or
+  /// null if none. The transform is held by the scene object, and the
+  /// other components by the component store of its scene, so the
+  /// lookup takes constant time.
+  template <typename T>
+  T* getComponent() const
+  {
+    if (!hasComponent<T>())
+      return nullptr;
+    return _store->components<T>().get(_entity);
+  }
+
+  /// Calls f(c) for each component c of type T of this scene object.
+  template <typename T, typename F>
+  void forEach(F f) const
+  {
+    if (hasComponent<T>())
+      for (auto& component : componentColection)
+        if (auto c = component->template as<T>())
+          f(c);
+  }
+
+  /// \brief Adds a component to this scene object, unless it has one
+  /// of the same type. A scene object has one transform, added by its
+  /// constructor, and at most one primitive and one camera.
+  void addComponent(Component* component)
+  {
+    const auto type = component->typeId();
+
+    assert(type >= 0 && type < maxComponentTypes);
+
+    const auto bit = ComponentMask(1) << type;
+
+    if ((_componentMask & bit) != 0 ||
+      (type == Transform::componentTypeId && component != _transform))
+      return;
+    if (_attached)
+      storeComponent(component);
+    _componentMask |= bit;
+    component->_sceneObject = this;
+    componentColection.push_back(Component::makeUse(component));
+    invalidateBounds();
+  }
+
+  void removeComponent(Reference<Component> component)
+  {
+    auto end = componentColection.end();
+
+    for (auto it = componentColection.begin(); it != end; ++it)
+      if (*it == component)
+      {
+        const auto type = component->typeId();
+
+        unstoreComponent(type);
+        _componentMask &= ~(ComponentMask(1) << type);
+        componentColection.erase(it);
+        invalidateBounds();
+        break;
+      }
+  }
 
 	auto sizeComponent() {
 		return componentColection.size();
@@ -166,10 +205,17 @@ public:
 
 	void addSceneObject(SceneObject* object) {
 		sceneObjectColection.push_back(SceneObject::makeUse(object));
+		object->setAttached(_attached);
+		invalidateBounds();
+		hierarchyChanged();
 	}
 
 	void removeSceneObject(SceneObject* object) {
+		// Detached before it is released by the list
+		object->setAttached(false);
 		sceneObjectColection.remove(object);
+		invalidateBounds();
+		hierarchyChanged();
 	}
 
 	auto sizeSceneObject() {
@@ -180,13 +226,55 @@ private:
   Scene* _sceneCurrent;
   SceneObject* _parent;
   Transform* _transform;
+  Reference<ComponentStore> _store;
+  int _entity;
+  ComponentMask _componentMask{};
+  bool _attached{};
 	std::list<Reference<SceneObject>> sceneObjectColection;
 	std::vector<Reference<Component>> componentColection;
+  mutable Bounds3f _bounds;
+  mutable bool _invalidBounds{true};
+
+  void hierarchyChanged(); // implemented in SceneObject.cpp
+  void setAttached(bool); // implemented in SceneObject.cpp
+
+  void storeComponent(Component* component)
+  {
+    switch (component->typeId())
+    {
+      case Primitive::componentTypeId:
+        _store->array<Primitive>().add(_entity, (Primitive*)component);
+        break;
+      case Camera::componentTypeId:
+        _store->array<Camera>().add(_entity, (Camera*)component);
+        break;
+    }
+  }
+
+  void unstoreComponent(ComponentTypeId type)
+  {
+    switch (type)
+    {
+      case Primitive::componentTypeId:
+        _store->array<Primitive>().remove(_entity);
+        break;
+      case Camera::componentTypeId:
+        _store->array<Camera>().remove(_entity);
+        break;
+    }
+  }
 
   friend class Scene;
 
 }; // SceneObject
 
+template <>
+inline Transform*
+SceneObject::getComponent<Transform>() const
+{
+  return _transform;
+}
+
 /// Returns the transform of a component.
 inline Transform*
 Component::transform() { // declared in Component.h
@@ -202,6 +290,14 @@ Transform::parent() const // declared in Transform.h
    return nullptr;
 }
 
+/// Invalidates the bounds of the scene object of a primitive.
+inline void
+Primitive::meshChanged() const // declared in Primitive.h
+{
+  if (auto object = sceneObject())
+    object->invalidateBounds();
+}
+
 } // end namespace cg
 
 #endif // __SceneObject_h
@@ -30,33 +30,11 @@
 // Author(s): Paulo Pagliosa, Carlos Monteiro e Yago Mescolotte
 // Last revision: 15/10/2019
 
-#include "SceneObject.h"
+#include "Scene.h"
 
 namespace cg
 { // begin namespace cg
 
-template <typename real>
-inline Matrix4x4<real>
-inverseTRS(const Matrix4x4<real>& trs)
-{
-  auto u = Vector3<real>{trs[0]};
-  auto v = Vector3<real>{trs[1]};
-  auto w = Vector3<real>{trs[2]};
-
-  u *= math::inverse(u.squaredNorm());
-  v *= math::inverse(v.squaredNorm());
-  w *= math::inverse(w.squaredNorm());
-
-  auto p = Vector3<real>{trs[3]};
-  Matrix4x4<real> inv;
-
-  inv[0].set(u.x, v.x, w.x);
-  inv[1].set(u.y, v.y, w.y);
-  inv[2].set(u.z, v.z, w.z);
-  inv[3].set(-(u.dot(p)), -(v.dot(p)), -(w.dot(p)), real(1));
-  return inv;
-}
-
 template <typename real>
 inline Vector3<real>
 translation(const Matrix4x4<real>& trs)
@@ -68,8 +46,13 @@ template <typename real>
 inline Vector3<real>
 scale(const Quaternion<real>& q, const Matrix4x4<real>& m)
 {
-  using mat3 = Matrix3x3<real>;
-  return (mat3{q.inverse()} * mat3{m}).diagonal();
+  // Diagonal of the inverse of q times m, i.e., the dot products of the
+  // columns of q and m
+  Matrix3x3<real> r{q};
+
+  return {r[0].dot(Vector3<real>{m[0]}),
+    r[1].dot(Vector3<real>{m[1]}),
+    r[2].dot(Vector3<real>{m[2]})};
 }
 
 
@@ -77,45 +60,23 @@ scale(const Quaternion<real>& q, const Matrix4x4<real>& m)
 //
 // Transform implementation
 // =========
-Transform::Transform():
-  Component{"Transform"},
-  _localPosition{0.0f},
-  _localRotation{quatf::identity()},
-  _localEulerAngles{0.0f},
-  _localScale{1.0f},
-  _matrix{1.0}
+Transform::Transform(TransformStore& store):
+  Component{"Transform", componentTypeId},
+  _store{&store},
+  _index{store.add(this)}
 {
-  _position = _localPosition;
-  _rotation = _localRotation;
-  _lossyScale = _localScale;
-  _inverseMatrix = _matrix;
+  // do nothing
 }
 
-inline mat4f
-Transform::localMatrix() const
+Transform::~Transform()
 {
-  return mat4f::TRS(_localPosition, _localRotation, _localScale);
+  _store->remove(_index);
 }
 
-inline mat4f
-Transform::inverseLocalMatrix() const
+vec3f
+Transform::lossyScale() const
 {
-  mat3f r{_localRotation};
-
-  r[0] *= math::inverse(_localScale[0]);
-  r[1] *= math::inverse(_localScale[1]);
-  r[2] *= math::inverse(_localScale[2]);
-
-  mat4f m;
-
-  m[0].set(r[0][0], r[1][0], r[2][0]);
-  m[1].set(r[0][1], r[1][1], r[2][1]);
-  m[2].set(r[0][2], r[1][2], r[2][2]);
-  m[3][0] = -(r[0].dot(_localPosition));
-  m[3][1] = -(r[1].dot(_localPosition));
-  m[3][2] = -(r[2].dot(_localPosition));
-  m[3][3] = 1.0f;
-  return m;
+  return scale(rotation(), localToWorldMatrix());
 }
 
 void
@@ -127,95 +88,88 @@ Transform::setPosition(const vec3f& position)
 void
 Transform::setRotation(const quatf& rotation)
 {
-  setLocalRotation(parent()->_rotation.inverse() * rotation);
+  setLocalRotation(parent()->rotation().inverse() * rotation);
 }
 
 void
 Transform::translate(const vec3f& t, Space space)
 {
   if (space == Space::Local)
-    setPosition(_position + transformDirection(t));
+    setPosition(position() + transformDirection(t));
   else
-    setPosition(_position + t);
+    setPosition(position() + t);
 }
 
 void
 Transform::rotate(const quatf& q, Space space)
 {
   if (space == Space::World)
-    setLocalRotation(_localRotation * (_rotation.inverse() * q * _rotation));
+  {
+    const auto& r = rotation();
+
+    setLocalRotation(localRotation() * (r.inverse() * q * r));
+  }
   else
-    setLocalRotation(_localRotation * q);
+    setLocalRotation(localRotation() * q);
 }
 
 void
 Transform::reset()
 {
-  _localPosition = _localEulerAngles = vec3f{0.0f};
-  _localRotation = quatf::identity();
-  _localScale = vec3f{1.0f};
-  update();
+  set(_store->_localPosition, vec3f{0.0f});
+  set(quatf::identity());
+  set(_store->_localScale, vec3f{1.0f});
+  _store->_localEulerAngles[_index] = vec3f{0.0f};
+  invalidate();
 }
 
 void
-Transform::update()
+Transform::update() const
 {
   auto p = parent();
 
-  _matrix = p->_matrix * localMatrix();
-  _position = translation(_matrix);
-  _rotation = p->_rotation * _localRotation;
-  _lossyScale = scale(_rotation, _matrix);
-  _inverseMatrix = inverseLocalMatrix() * p->_inverseMatrix;
-  
-	// update the transform of all scene object's children.
-	auto begin = sceneObject()->IteratorSceneObject();
-	auto end = sceneObject()->IteratorEndSceneObject();
-	for (auto it = begin; it != end; it++)
-	{
-		(*it)->transform()->update();
-	}
-
-  changed = true;
+  if (p != nullptr)
+    p->validate();
+  _store->update(_index, p != nullptr ? p->_index : -1);
+}
+
+void
+Transform::invalidate()
+{
+  // The descendants of a dirty transform are dirty as well
+  if (!_store->_dirty[_index])
+    sceneObject()->scene()->invalidateTransform(this);
 }
 
 void
 Transform::parentChanged()
 {
+  // The world data are kept, so they must be the ones computed with
+  // the previous parent
   auto p = parent();
-  auto m = p->_inverseMatrix * _matrix;
-
-  _localPosition = translation(m);
-  _localRotation = p->_rotation.inverse() * _rotation;
-  _localEulerAngles = _localRotation.eulerAngles();
-  _localScale = scale(_localRotation, m);
-  _matrix = p->_matrix * localMatrix();
-  _lossyScale = scale(_rotation, _matrix);
-  _inverseMatrix = inverseLocalMatrix() * p->_inverseMatrix;
-  
-	// update the transform of all scene object's children.
-	auto begin = sceneObject()->IteratorSceneObject();
-	auto end = sceneObject()->IteratorSceneObject();
-	for (auto it = begin; it != end; it++)
-	{
-		(*it)->transform()->update();
-	}
-	
-  changed = true;
+  const auto& matrix = _store->_matrix[_index];
+  auto m = p->worldToLocalMatrix() * matrix;
+  auto q = p->rotation().inverse() * _store->_rotation[_index];
+
+  set(_store->_localPosition, translation(m));
+  set(q);
+  _store->_localEulerAngles[_index] = q.eulerAngles();
+  set(_store->_localScale, scale(q, m));
+  invalidate();
 }
 
 void
 Transform::print(FILE* out) const
 {
   fprintf(out, "Name: %s\n", sceneObject()->name());
-  _localPosition.print("Local position: ", out);
-  _localEulerAngles.print("Local rotation: ", out);
-  _localScale.print("Local scale: ", out);
-  _position.print("Position: ", out);
-  _rotation.eulerAngles().print("Rotation: ", out);
-  _lossyScale.print("Lossy scale: ", out);
-  _matrix.print("Local2WorldMatrix", out);
-  _inverseMatrix.print("World2LocalMatrix", out);
+  localPosition().print("Local position: ", out);
+  localEulerAngles().print("Local rotation: ", out);
+  localScale().print("Local scale: ", out);
+  position().print("Position: ", out);
+  eulerAngles().print("Rotation: ", out);
+  lossyScale().print("Lossy scale: ", out);
+  localToWorldMatrix().print("Local2WorldMatrix", out);
+  worldToLocalMatrix().print("World2LocalMatrix", out);
 }
 
 } // end namespace cg
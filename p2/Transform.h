@@ -34,7 +34,7 @@
 #define __Transform_h
 
 #include "Component.h"
-#include "math/Matrix4x4.h"
+#include "TransformStore.h"
 
 namespace cg
 { // begin namespace cg
@@ -44,75 +44,101 @@ namespace cg
 //
 // Transform: scene object transform class
 // =========
+//
+// A transform is a handle to a slot of the transform store of its
+// scene, which holds its data (see TransformStore).
+//
+// The setters of a transform only change its local data and mark it and
+// its descendants as dirty, so that editing a transform several times
+// is cheap. The world data of a dirty transform are computed when read,
+// or by Scene::updateTransforms() once per frame, parent first.
 class Transform final: public Component
 {
 public:
+  static constexpr ComponentTypeId componentTypeId =
+    componentTypeIdOf<Transform>();
+
   enum class Space
   {
     Local,
     World
   };
 
-  bool changed{false};
+  /// Constructs an identity transform in \c store.
+  Transform(TransformStore& store);
+
+  /// Destructor.
+  ~Transform();
+
+  /// \brief Returns true if the world data of this transform were
+  /// computed since the flag was last cleared by whom consumes them.
+  bool changed() const
+  {
+    return _store->_changed[_index] != 0;
+  }
 
-  /// Constructs an identity transform.
-  Transform();
+  /// Sets or clears the changed flag of this transform.
+  void setChanged(bool changed)
+  {
+    _store->_changed[_index] = changed;
+  }
 
   /// Returns the parent of this transform.
   Transform* parent() const; // implemented in SceneObject.h
 
   /// Returns the local position of this transform.
-  const vec3f& localPosition() const
+  vec3f localPosition() const
   {
-    return _localPosition;
+    return get(_store->_localPosition);
   }
 
   /// Returns the local rotation of this transform.
-  const quatf& localRotation() const
+  quatf localRotation() const
   {
-    return _localRotation;
+    const auto& r = _store->_localRotation;
+    return {r[0][_index], r[1][_index], r[2][_index], r[3][_index]};
   }
 
   /// Returns the local Euler angles (in degrees) of this transform.
   const vec3f& localEulerAngles() const
   {
-    return _localEulerAngles;
+    return _store->_localEulerAngles[_index];
   }
 
   /// Returns the local scale of this transform.
-  const vec3f& localScale() const
+  vec3f localScale() const
   {
-    return _localScale;
+    return get(_store->_localScale);
   }
 
   /// Sets the local position of this transform.
   void setLocalPosition(const vec3f& position)
   {
-    _localPosition = position;
-    update();
+    set(_store->_localPosition, position);
+    invalidate();
   }
 
   /// Sets the local rotation of this transform.
   void setLocalRotation(const quatf& rotation)
   {
-    _localEulerAngles = rotation.eulerAngles();
-    _localRotation = rotation;
-    update();
+    _store->_localEulerAngles[_index] = rotation.eulerAngles();
+    set(rotation);
+    invalidate();
   }
 
   /// Sets the local Euler angles (in degrees) of this transform.
   void setLocalEulerAngles(const vec3f& angles)
   {
-    _localEulerAngles = angles;
-    _localRotation = quatf::eulerAngles(angles);
-    update();
+    _store->_localEulerAngles[_index] = angles;
+    set(quatf::eulerAngles(angles));
+    invalidate();
   }
 
   /// Sets the local scale of this transform.
   void setLocalScale(const vec3f& scale)
   {
-    _localScale = scale;
-    update();
+    set(_store->_localScale, scale);
+    invalidate();
   }
 
   /// Sets the local uniform scale of this transform.
@@ -122,45 +148,43 @@ public:
   }
 
   /// Returns the world position of this transform.
-  const vec3f& position() const
+  vec3f position() const
   {
-    return _position;
+    return vec3f{localToWorldMatrix()[3]};
   }
 
   /// Returns the world rotation of this transform.
   const quatf& rotation() const
   {
-    return _rotation;
+    validate();
+    return _store->_rotation[_index];
   }
 
   /// Returns the world Euler angles (in degrees) of this transform.
   vec3f eulerAngles() const
   {
-    return _rotation.eulerAngles();
+    return rotation().eulerAngles();
   }
 
   /// Returns the global scale of this transform.
-  const vec3f& lossyScale() const
-  {
-    return _lossyScale;
-  }
+  vec3f lossyScale() const;
 
   /// Returns the direction of the world Z axis of this transform.
   vec3f forward() const
   {
-    return _rotation * vec3f{0, 0, 1};
+    return rotation() * vec3f{0, 0, 1};
   }
 
   /// Returns the direction of the world Y axis of this transform.
   vec3f up() const
   {
-    return _rotation * vec3f::up();
+    return rotation() * vec3f::up();
   }
 
   /// Returns the direction of the world Z axis of this transform.
   vec3f right() const
   {
-    return _rotation * vec3f{1, 0, 0};
+    return rotation() * vec3f{1, 0, 0};
   }
 
   /// Sets the world position of this transform.
@@ -193,43 +217,45 @@ public:
   /// Returns the local to world _matrix of this transform.
   const mat4f& localToWorldMatrix() const
   {
-    return _matrix;
+    validate();
+    return _store->_matrix[_index];
   }
 
   /// Returns the world to local _matrix of this transform.
   const mat4f& worldToLocalMatrix() const
   {
-    return _inverseMatrix;
+    validate();
+    return _store->_inverseMatrix[_index];
   }
 
   /// Transforms \c p from local space to world space.
   vec3f transform(const vec3f& p) const
   {
-    return _matrix.transform3x4(p);
+    return localToWorldMatrix().transform3x4(p);
   }
 
   /// Transforms \c p from world space to local space.
   vec3f inverseTransform(const vec3f& p) const
   {
-    return _inverseMatrix.transform3x4(p);
+    return worldToLocalMatrix().transform3x4(p);
   }
 
   /// Transforms \c v from local space to world space.
   vec3f transformVector(const vec3f& v) const
   {
-    return _matrix.transformVector(v);
+    return localToWorldMatrix().transformVector(v);
   }
 
   /// Transforms \c v from world space to local space.
   vec3f inverseTransformVector(const vec3f& v) const
   {
-    return _inverseMatrix.transformVector(v);
+    return worldToLocalMatrix().transformVector(v);
   }
 
   /// Transforms \c d from world space to local space.
   vec3f transformDirection(const vec3f& d) const
   {
-    return _rotation.rotate(d);
+    return rotation().rotate(d);
   }
 
   /// Sets this transform as an identity transform.
@@ -238,24 +264,48 @@ public:
   void print(FILE* out = stdout) const;
 
 private:
-  vec3f _localPosition;
-  quatf _localRotation;
-  vec3f _localEulerAngles;
-  vec3f _localScale;
-  vec3f _position;
-  quatf _rotation;
-  vec3f _lossyScale;
-  mat4f _matrix;
-  mat4f _inverseMatrix;
-
-  mat4f localMatrix() const;
-  mat4f inverseLocalMatrix() const;
+  Reference<TransformStore> _store;
+  int _index;
+  // Range of this transform and its descendants in the flattened
+  // hierarchy of the scene (see Scene::updateTransforms())
+  int _first{-1};
+  int _end{-1};
+
+  vec3f get(const std::vector<float> a[3]) const
+  {
+    return {a[0][_index], a[1][_index], a[2][_index]};
+  }
+
+  void set(std::vector<float> a[3], const vec3f& v)
+  {
+    for (int i = 0; i < 3; ++i)
+      a[i][_index] = v[i];
+  }
+
+  void set(const quatf& q)
+  {
+    auto& r = _store->_localRotation;
+
+    r[0][_index] = q.x;
+    r[1][_index] = q.y;
+    r[2][_index] = q.z;
+    r[3][_index] = q.w;
+  }
+
+  void validate() const
+  {
+    if (_store->_dirty[_index])
+      update();
+  }
 
   void rotate(const quatf&, Space = Space::Local);
-  void update();
+  void update() const;
+  void invalidate();
   void parentChanged();
 
+  friend class Scene;
   friend class SceneObject;
+  friend class TransformStore;
 
 }; // Transform
 
@@ -0,0 +1,361 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: TransformStore.cpp
+// ========
+// Source file for transform store.
+//
+// Author(s): Paulo Pagliosa, Carlos Monteiro e Yago Mescolotte
+// Last revision: 17/10/2026
+
+#include "TransformStore.h"
+#include "Transform.h"
+#include "math/SIMD.h"
+
+namespace cg
+{ // begin namespace cg
+
+namespace
+{ // begin namespace
+
+// Local and parent data of N slots, one vector per component. The
+// matrices are 3x4, row major. The inverse world matrices are computed
+// along with the world ones, as the product of the inverse local and
+// parent ones, so that reading them writes nothing
+template <int N>
+struct Lanes
+{
+  using vfloat = simd::vfloat<N>;
+
+  vfloat p[3];
+  vfloat q[4];
+  vfloat s[3];
+  vfloat pm[12];
+  vfloat pi[12];
+  vfloat pq[4];
+  vfloat m[12];
+  vfloat mi[12];
+  vfloat r[4];
+
+  // Computes the world matrix m = pm * TRS(p, q, s), its inverse
+  // mi = TRS(p, q, s)^-1 * pi and the world rotation r = pq * q. The
+  // rotation matrix is the one of mat3f(quatf)
+  void compute()
+  {
+    const vfloat zero{0.0f};
+    const vfloat one{1.0f};
+    const auto x2 = q[0] + q[0];
+    const auto y2 = q[1] + q[1];
+    const auto z2 = q[2] + q[2];
+    const auto xx = q[0] * x2;
+    const auto yy = q[1] * y2;
+    const auto zz = q[2] * z2;
+    const auto xy = q[1] * x2;
+    const auto xz = q[2] * x2;
+    const auto xw = q[3] * x2;
+    const auto yz = q[2] * y2;
+    const auto yw = q[3] * y2;
+    const auto zw = q[3] * z2;
+    // Local matrix, row major
+    const vfloat l[12]
+    {
+      (one - (yy + zz)) * s[0], (xy - zw) * s[1], (xz + yw) * s[2], p[0],
+      (xy + zw) * s[0], (one - (xx + zz)) * s[1], (yz - xw) * s[2], p[1],
+      (xz - yw) * s[0], (yz + xw) * s[1], (one - (xx + yy)) * s[2], p[2]
+    };
+
+    for (int i = 0; i < 3; ++i)
+    {
+      const auto a = pm + 4 * i;
+
+      for (int j = 0; j < 3; ++j)
+        m[4 * i + j] = a[0] * l[j] + a[1] * l[4 + j] + a[2] * l[8 + j];
+      m[4 * i + 3] = a[0] * l[3] + a[1] * l[7] + a[2] * l[11] + a[3];
+    }
+
+    // Inverse local matrix, row major: the rows of S^-1 * R^T and the
+    // translation -S^-1 * R^T * p
+    const vfloat is[3]{one / s[0], one / s[1], one / s[2]};
+    vfloat li[12]
+    {
+      (one - (yy + zz)) * is[0], (xy + zw) * is[0], (xz - yw) * is[0], zero,
+      (xy - zw) * is[1], (one - (xx + zz)) * is[1], (yz + xw) * is[1], zero,
+      (xz + yw) * is[2], (yz - xw) * is[2], (one - (xx + yy)) * is[2], zero
+    };
+
+    for (int i = 0; i < 3; ++i)
+    {
+      const auto a = li + 4 * i;
+
+      a[3] = zero - (a[0] * p[0] + a[1] * p[1] + a[2] * p[2]);
+      for (int j = 0; j < 3; ++j)
+        mi[4 * i + j] = a[0] * pi[j] + a[1] * pi[4 + j] + a[2] * pi[8 + j];
+      mi[4 * i + 3] = a[0] * pi[3] + a[1] * pi[7] + a[2] * pi[11] + a[3];
+    }
+    r[0] = pq[3] * q[0] + q[3] * pq[0] + pq[1] * q[2] - q[1] * pq[2];
+    r[1] = pq[3] * q[1] + q[3] * pq[1] + pq[2] * q[0] - q[2] * pq[0];
+    r[2] = pq[3] * q[2] + q[3] * pq[2] + pq[0] * q[1] - q[0] * pq[1];
+    r[3] = pq[3] * q[3] - q[0] * pq[0] - pq[1] * q[1] - q[2] * pq[2];
+  }
+
+}; // Lanes
+
+} // end namespace
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// TransformStore implementation
+// ==============
+int
+TransformStore::add(Transform* owner)
+{
+  int slot;
+
+  if (!_free.empty())
+  {
+    slot = _free.back();
+    _free.pop_back();
+  }
+  else
+  {
+    slot = size();
+    for (auto& a : _localPosition)
+      a.emplace_back();
+    for (auto& a : _localRotation)
+      a.emplace_back();
+    for (auto& a : _localScale)
+      a.emplace_back();
+    _localEulerAngles.emplace_back();
+    _parent.emplace_back();
+    _matrix.emplace_back();
+    _inverseMatrix.emplace_back();
+    _rotation.emplace_back();
+    _dirty.emplace_back();
+    _changed.emplace_back();
+    _owner.emplace_back();
+  }
+  for (int i = 0; i < 3; ++i)
+  {
+    _localPosition[i][slot] = 0;
+    _localRotation[i][slot] = 0;
+    _localScale[i][slot] = 1;
+  }
+  _localRotation[3][slot] = 1;
+  _localEulerAngles[slot] = vec3f{0.0f};
+  _parent[slot] = -1;
+  _matrix[slot] = _inverseMatrix[slot] = mat4f::identity();
+  _rotation[slot] = quatf::identity();
+  _dirty[slot] = _changed[slot] = 0;
+  _owner[slot] = owner;
+  return slot;
+}
+
+void
+TransformStore::remove(int slot)
+{
+  _owner[slot] = nullptr;
+  _free.push_back(slot);
+}
+
+template <typename T>
+inline void
+permute(std::vector<T>& a, const std::vector<int>& order)
+{
+  std::vector<T> b(order.size());
+
+  for (size_t i = 0; i < order.size(); ++i)
+    b[i] = a[order[i]];
+  a.swap(b);
+}
+
+void
+TransformStore::reorder(const std::vector<int>& order)
+{
+  // New slot of each old slot, or -1 if not in use
+  std::vector<int> map(_owner.size(), -1);
+  std::vector<int> all;
+
+  all.reserve(_owner.size());
+  for (auto slot : order)
+  {
+    map[slot] = int(all.size());
+    all.push_back(slot);
+  }
+  for (int slot = 0, n = size(); slot < n; ++slot)
+    if (map[slot] < 0 && _owner[slot] != nullptr)
+    {
+      map[slot] = int(all.size());
+      all.push_back(slot);
+    }
+  for (auto& a : _localPosition)
+    permute(a, all);
+  for (auto& a : _localRotation)
+    permute(a, all);
+  for (auto& a : _localScale)
+    permute(a, all);
+  permute(_localEulerAngles, all);
+  permute(_parent, all);
+  permute(_matrix, all);
+  permute(_inverseMatrix, all);
+  permute(_rotation, all);
+  permute(_dirty, all);
+  permute(_changed, all);
+  permute(_owner, all);
+  for (auto& parent : _parent)
+    if (parent >= 0)
+      parent = map[parent];
+  for (int slot = 0, n = size(); slot < n; ++slot)
+    _owner[slot]->_index = slot;
+  _free.clear();
+}
+
+void
+TransformStore::compute(int slot, int parent)
+{
+  Lanes<1> x;
+
+  for (int i = 0; i < 3; ++i)
+  {
+    x.p[i] = _localPosition[i][slot];
+    x.s[i] = _localScale[i][slot];
+  }
+  for (int i = 0; i < 4; ++i)
+    x.q[i] = _localRotation[i][slot];
+
+  const auto& pm = parent >= 0 ? _matrix[parent] : mat4f::identity();
+  const auto& pi = parent >= 0 ? _inverseMatrix[parent] : mat4f::identity();
+  const auto& pq = parent >= 0 ? _rotation[parent] : quatf::identity();
+
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 4; ++j)
+    {
+      x.pm[4 * i + j] = pm[j][i];
+      x.pi[4 * i + j] = pi[j][i];
+    }
+  for (int i = 0; i < 4; ++i)
+    x.pq[i] = (&pq.x)[i];
+  x.compute();
+
+  auto& m = _matrix[slot];
+  auto& mi = _inverseMatrix[slot];
+
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 4; ++j)
+    {
+      m[j][i] = x.m[4 * i + j][0];
+      mi[j][i] = x.mi[4 * i + j][0];
+    }
+  m[0][3] = m[1][3] = m[2][3] = mi[0][3] = mi[1][3] = mi[2][3] = 0;
+  m[3][3] = mi[3][3] = 1;
+  _rotation[slot].set(x.r[0][0], x.r[1][0], x.r[2][0], x.r[3][0]);
+}
+
+void
+TransformStore::update(int slot, int parent)
+{
+  compute(slot, parent);
+  _dirty[slot] = 0;
+  _changed[slot] = 1;
+}
+
+void
+TransformStore::updateLevel(int first, int last)
+{
+  constexpr auto N = simd::width;
+  using vfloat = simd::vfloat<N>;
+  Lanes<N> x;
+  alignas(32) float a[28][N];
+  auto slot = first;
+
+  for (; slot + N <= last; slot += N)
+  {
+    // The local data of the slots are loaded as they are; the ones of
+    // the parents are gathered
+    for (int i = 0; i < 3; ++i)
+    {
+      x.p[i] = vfloat::loadu(&_localPosition[i][slot]);
+      x.s[i] = vfloat::loadu(&_localScale[i][slot]);
+    }
+    for (int i = 0; i < 4; ++i)
+      x.q[i] = vfloat::loadu(&_localRotation[i][slot]);
+    for (int k = 0; k < N; ++k)
+    {
+      const auto parent = _parent[slot + k];
+      const auto& pm = _matrix[parent];
+      const auto& pi = _inverseMatrix[parent];
+      const auto& pq = _rotation[parent];
+
+      for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 4; ++j)
+        {
+          a[4 * i + j][k] = pm[j][i];
+          a[12 + 4 * i + j][k] = pi[j][i];
+        }
+      for (int i = 0; i < 4; ++i)
+        a[24 + i][k] = (&pq.x)[i];
+    }
+    for (int i = 0; i < 12; ++i)
+    {
+      x.pm[i] = vfloat::load(a[i]);
+      x.pi[i] = vfloat::load(a[12 + i]);
+    }
+    for (int i = 0; i < 4; ++i)
+      x.pq[i] = vfloat::load(a[24 + i]);
+    x.compute();
+    for (int i = 0; i < 12; ++i)
+    {
+      x.m[i].store(a[i]);
+      x.mi[i].store(a[12 + i]);
+    }
+    for (int i = 0; i < 4; ++i)
+      x.r[i].store(a[24 + i]);
+    for (int k = 0; k < N; ++k)
+    {
+      auto& m = _matrix[slot + k];
+      auto& mi = _inverseMatrix[slot + k];
+
+      for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 4; ++j)
+        {
+          m[j][i] = a[4 * i + j][k];
+          mi[j][i] = a[12 + 4 * i + j][k];
+        }
+      _rotation[slot + k].set(a[24][k], a[25][k], a[26][k], a[27][k]);
+    }
+  }
+  for (; slot < last; ++slot)
+    compute(slot, _parent[slot]);
+  // The world data of the clean slots are computed again, with the same
+  // results, so they are not marked as changed
+  for (slot = first; slot < last; ++slot)
+    if (_dirty[slot])
+    {
+      _dirty[slot] = 0;
+      _changed[slot] = 1;
+    }
+}
+
+} // end namespace cg
@@ -0,0 +1,123 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: TransformStore.h
+// ========
+// Class definition for transform store.
+//
+// Author(s): Paulo Pagliosa, Carlos Monteiro e Yago Mescolotte
+// Last revision: 17/10/2026
+
+#ifndef __TransformStore_h
+#define __TransformStore_h
+
+#include "core/SharedObject.h"
+#include "math/Matrix4x4.h"
+#include <vector>
+
+namespace cg
+{ // begin namespace cg
+
+// Forward definition
+class Transform;
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// TransformStore: transform store class
+// ==============
+//
+// Holds the data of the transforms of a scene in structure of arrays
+// layout, indexed by slot: the local positions, rotations and scales,
+// one array per component, the parent slots, the world matrices, their
+// inverses and rotations, and the dirty and changed flags. A transform
+// is a handle to a slot (see Transform). The inverse matrices are
+// computed with the world ones, so that the clean transforms can be
+// read by several threads at once.
+//
+// The world data of a range of slots whose parents precede the range
+// are computed four slots at a time with SSE. The scene keeps the slots
+// sorted by depth in the hierarchy, so each level is such a range. The
+// scalar and SSE paths compute the same arithmetic, so their results
+// are identical.
+class TransformStore: public SharedObject
+{
+public:
+  /// Returns the number of slots of this store.
+  int size() const
+  {
+    return int(_owner.size());
+  }
+
+  /// Adds an identity transform owned by \c owner and returns its slot.
+  int add(Transform* owner);
+
+  /// Frees \c slot, which is reused or dropped by the next reorder().
+  void remove(int slot);
+
+  /// \brief Moves the slots in \c order to the front of this store, in
+  /// that order, followed by the other slots in use, and updates the
+  /// slots of their owners.
+  void reorder(const std::vector<int>& order);
+
+  /// Sets the parent slot of \c slot, or -1 if none.
+  void setParent(int slot, int parent)
+  {
+    _parent[slot] = parent;
+  }
+
+  /// \brief Computes the world data of \c slot from the ones of \c parent,
+  /// or as the local ones if \c parent is -1.
+  void update(int slot, int parent);
+
+  /// \brief Computes the world data of the slots in [first, last) from
+  /// the ones of their parents, which must precede \c first. The dirty
+  /// slots are marked as changed.
+  void updateLevel(int first, int last);
+
+private:
+  std::vector<float> _localPosition[3];
+  std::vector<float> _localRotation[4];
+  std::vector<float> _localScale[3];
+  std::vector<vec3f> _localEulerAngles;
+  std::vector<int> _parent;
+  std::vector<mat4f> _matrix;
+  std::vector<mat4f> _inverseMatrix;
+  std::vector<quatf> _rotation;
+  std::vector<char> _dirty;
+  std::vector<char> _changed;
+  std::vector<Transform*> _owner;
+  std::vector<int> _free;
+
+  void compute(int, int);
+
+  friend class Scene;
+  friend class Transform;
+
+}; // TransformStore
+
+} // end namespace cg
+
+#endif // __TransformStore_h
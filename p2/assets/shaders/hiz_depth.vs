@@ -0,0 +1,10 @@
+#version 330 core
+
+uniform mat4 mvpMatrix;
+
+layout(location = 0) in vec4 position;
+
+void main()
+{
+  gl_Position = mvpMatrix * position;
+}
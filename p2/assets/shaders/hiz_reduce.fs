@@ -0,0 +1,19 @@
+#version 330 core
+
+// Level below the one written, set as the base level of the texture
+uniform sampler2D depth;
+
+void main()
+{
+  ivec2 size = textureSize(depth, 0);
+  ivec2 p = ivec2(gl_FragCoord.xy) * 2;
+  // The last texel of a level also covers the odd row or column below
+  int nx = (size.x & 1) != 0 && p.x + 3 == size.x ? 3 : 2;
+  int ny = (size.y & 1) != 0 && p.y + 3 == size.y ? 3 : 2;
+  float z = 0;
+
+  for (int y = 0; y < ny; ++y)
+    for (int x = 0; x < nx; ++x)
+      z = max(z, texelFetch(depth, min(p + ivec2(x, y), size - 1), 0).r);
+  gl_FragDepth = z;
+}
@@ -0,0 +1,9 @@
+#version 330 core
+
+// Triangle covering the viewport, drawn with no vertex buffer
+void main()
+{
+  vec2 p = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 4 - 1;
+
+  gl_Position = vec4(p, 0, 1);
+}
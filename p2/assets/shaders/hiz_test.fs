@@ -0,0 +1,10 @@
+#version 330 core
+
+flat in float visible;
+
+out vec4 fragmentColor;
+
+void main()
+{
+  fragmentColor = vec4(visible);
+}
@@ -0,0 +1,62 @@
+#version 330 core
+
+uniform mat4 vpMatrix;
+uniform sampler2D hiZ;
+uniform int levelCount;
+uniform vec2 resultSize;
+
+layout(location = 0) in vec3 boundsMin;
+layout(location = 1) in vec3 boundsMax;
+
+flat out float visible;
+
+// Returns 0 if the bounds are behind the farthest depth of the Hi-Z
+// texels they cover, or 1 otherwise
+float test()
+{
+  vec2 p0 = vec2(1);
+  vec2 p1 = vec2(-1);
+  float z = 1;
+
+  for (int i = 0; i < 8; ++i)
+  {
+    vec3 c = mix(boundsMin, boundsMax, vec3(i & 1, (i >> 1) & 1, i >> 2));
+    vec4 P = vpMatrix * vec4(c, 1);
+
+    // Bounds crossing the plane of the eye are taken as visible
+    if (P.w <= 0)
+      return 1;
+    P.xyz /= P.w;
+    p0 = min(p0, P.xy);
+    p1 = max(p1, P.xy);
+    z = min(z, P.z);
+  }
+
+  ivec2 size = textureSize(hiZ, 0);
+  ivec2 a = min(ivec2(clamp(p0 * 0.5 + 0.5, 0, 1) * size), size - 1);
+  ivec2 b = min(ivec2(clamp(p1 * 0.5 + 0.5, 0, 1) * size), size - 1);
+  ivec2 e = b - a;
+  // Finest level where the bounds cover at most 2x2 texels
+  int level = min(int(ceil(log2(float(max(e.x, e.y) + 1)))), levelCount - 1);
+  ivec2 s = textureSize(hiZ, level) - 1;
+
+  a = min(a >> level, s);
+  b = min(b >> level, s);
+
+  float d = max(max(texelFetch(hiZ, a, level).r,
+    texelFetch(hiZ, ivec2(b.x, a.y), level).r),
+    max(texelFetch(hiZ, ivec2(a.x, b.y), level).r,
+    texelFetch(hiZ, b, level).r));
+
+  return float(z * 0.5 + 0.5 <= d);
+}
+
+// Writes the result of the bounds i into the texel i of the result
+void main()
+{
+  int w = int(resultSize.x);
+  vec2 p = vec2(gl_VertexID % w, gl_VertexID / w) + 0.5;
+
+  visible = test();
+  gl_Position = vec4(p / resultSize * 2 - 1, 0, 1);
+}
@@ -1,13 +1,21 @@
 #version 330 core
 
-uniform mat4 transform;
-uniform mat3 normalMatrix;
-uniform mat4 vpMatrix = mat4(1);
-uniform vec4 color;
-uniform vec4 ambientLight = vec4(0.2, 0.2, 0.2, 1);
-uniform vec3 lightPosition;
+layout(std140) uniform FrameBlock
+{
+  mat4 vpMatrix;
+  vec4 ambientLight;
+  vec3 lightPosition;
+};
+
+layout(std140) uniform ObjectBlock
+{
+  mat4 transform;
+  mat3 normalMatrix;
+  vec4 color;
+  int flatMode;
+};
+
 uniform vec4 lightColor = vec4(1);
-uniform int flatMode;
 
 layout(location = 0) in vec4 position;
 layout(location = 1) in vec3 normal;
@@ -0,0 +1,31 @@
+#version 330 core
+
+layout(std140) uniform FrameBlock
+{
+  mat4 vpMatrix;
+  vec4 ambientLight;
+  vec3 lightPosition;
+};
+
+uniform vec4 lightColor = vec4(1);
+uniform int flatMode;
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec3 normal;
+// Per instance
+layout(location = 2) in mat4 transform;
+layout(location = 6) in mat3 normalMatrix;
+layout(location = 9) in vec4 color;
+
+out vec4 vertexColor;
+
+void main()
+{
+  vec4 P = transform * position;
+  vec3 L = normalize(lightPosition - vec3(P));
+  vec3 N = normalize(normalMatrix * normal);
+  vec4 A = ambientLight * float(1 - flatMode);
+
+  gl_Position = vpMatrix * P;
+  vertexColor = A + color * lightColor * max(dot(N, L), float(flatMode));
+}
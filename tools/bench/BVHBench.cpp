@@ -0,0 +1,192 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: BVHBench.cpp
+// ========
+// Triangle mesh BVH build and traversal benchmark.
+//
+// Author: Paulo Pagliosa
+// Last revision: 18/10/2026
+
+#include "geometry/BVH.h"
+#include "utils/MeshReader.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace cg;
+using clock_type = std::chrono::steady_clock;
+
+namespace
+{ // begin namespace
+
+constexpr int sphereResolution = 700;
+constexpr int defaultRayCount = 1000000;
+constexpr int checkedRayCount = 300;
+
+inline double
+seconds(clock_type::time_point start)
+{
+  return std::chrono::duration<double>{clock_type::now() - start}.count();
+}
+
+// Bumpy unit sphere of 2n^2 triangles
+TriangleMesh*
+makeSphere(int n)
+{
+  TriangleMesh::Data data;
+
+  data.numberOfVertices = (n + 1) * (n + 1);
+  data.vertices = new vec3f[data.numberOfVertices];
+  data.vertexNormals = nullptr;
+  data.numberOfTriangles = 2 * n * n;
+  data.triangles = new TriangleMesh::Triangle[data.numberOfTriangles];
+
+  const auto pi = float(M_PI);
+  auto v = data.vertices;
+
+  for (int i = 0; i <= n; ++i)
+    for (int j = 0; j <= n; ++j)
+    {
+      auto theta = pi * i / n;
+      auto phi = 2 * pi * j / n;
+      auto r = 1 + 0.1f * sinf(7 * theta) * cosf(9 * phi);
+
+      (v++)->set(r * sinf(theta) * cosf(phi),
+        r * cosf(theta),
+        r * sinf(theta) * sinf(phi));
+    }
+
+  auto t = data.triangles;
+
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+    {
+      auto a = i * (n + 1) + j;
+      auto c = a + n + 1;
+
+      (t++)->setVertices(a, a + 1, c);
+      (t++)->setVertices(a + 1, c + 1, c);
+    }
+  return new TriangleMesh{data};
+}
+
+// Closest hit by testing every triangle
+bool
+intersectAll(const BVH& bvh, Ray ray, BVH::Hit& hit)
+{
+  bool found = false;
+
+  for (int i = 0, n = bvh.mesh()->data().numberOfTriangles; i < n; ++i)
+    if (bvh.intersectTriangle(ray, i, hit))
+    {
+      ray.tMax = hit.distance;
+      found = true;
+    }
+  return found;
+}
+
+} // end namespace
+
+int
+main(int argc, char** argv)
+{
+  // Usage: BVHBench [file.obj [rays]]
+  Reference<TriangleMesh> mesh{argc > 1 ?
+    MeshReader::readOBJ(argv[1]) :
+    makeSphere(sphereResolution)};
+
+  if (mesh == nullptr)
+  {
+    printf("Unable to read %s\n", argv[1]);
+    return 1;
+  }
+
+  const auto rayCount = argc > 2 ? atoi(argv[2]) : defaultRayCount;
+
+  printf("%d triangles\n", mesh->data().numberOfTriangles);
+
+  auto start = clock_type::now();
+  Reference<BVH> bvh{new BVH{*mesh}};
+
+  printf("build %.3f s, %d nodes\n",
+    seconds(start),
+    int(bvh->nodes().size()));
+
+  // Rays from random points on a sphere enclosing the mesh toward
+  // random points in the central part of its bounds
+  const auto bounds = bvh->bounds();
+  const auto center = bounds.center();
+  const auto radius = bounds.diagonalLength();
+  const auto size = bounds.size() * 0.4f;
+  std::mt19937 g{1};
+  std::uniform_real_distribution<float> u{-1, 1};
+  std::vector<Ray> rays(rayCount);
+
+  for (auto& ray : rays)
+  {
+    auto o = center + vec3f{u(g), u(g), u(g)}.versor() * radius;
+    auto t = center + vec3f{u(g) * size.x, u(g) * size.y, u(g) * size.z};
+
+    ray = Ray{o, t - o};
+  }
+
+  BVH::Hit hit;
+  int hits = 0;
+
+  start = clock_type::now();
+  for (const auto& ray : rays)
+    hits += bvh->intersect(ray, hit);
+
+  auto t = seconds(start);
+
+  printf("closest hit: %d hits, %.2f Mrays/s\n", hits, rayCount / t * 1e-6);
+  hits = 0;
+  start = clock_type::now();
+  for (const auto& ray : rays)
+    hits += bvh->intersect(ray);
+  t = seconds(start);
+  printf("any hit: %d hits, %.2f Mrays/s\n", hits, rayCount / t * 1e-6);
+
+  // Check the closest hits against a loop over all triangles
+  int mismatches = 0;
+  int checked = std::min(rayCount, checkedRayCount);
+
+  for (int i = 0; i < checked; ++i)
+  {
+    BVH::Hit h;
+    auto found = intersectAll(*bvh, rays[i], h);
+
+    if (found != bvh->intersect(rays[i], hit) ||
+      (found && h.distance != hit.distance))
+      ++mismatches;
+  }
+  printf("brute force mismatches: %d of %d rays\n", mismatches, checked);
+  return 0;
+}
@@ -0,0 +1,116 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: HierarchyBench.cpp
+// ========
+// Transform hierarchy update benchmark.
+//
+// Author(s): Paulo Pagliosa, Carlos Monteiro e Yago Mescolotte
+// Last revision: 18/10/2026
+
+#include "Scene.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace cg;
+using clock_type = std::chrono::steady_clock;
+
+namespace
+{ // begin namespace
+
+constexpr int defaultSize = 100000;
+constexpr int defaultFanout = 8;
+constexpr int frameCount = 10;
+
+} // end namespace
+
+int
+main(int argc, char** argv)
+{
+  // Usage: HierarchyBench [nodes [fanout]]
+  const auto n = argc > 1 ? atoi(argv[1]) : defaultSize;
+  const auto fanout = argc > 2 ? atoi(argv[2]) : defaultFanout;
+  Reference<Scene> scene{new Scene{"bench"}};
+  std::vector<SceneObject*> objects(n);
+
+  // Tree in which the parent of the node i > 0 is the node (i - 1) / fanout
+  for (int i = 0; i < n; ++i)
+  {
+    auto object = new SceneObject{"object", *scene};
+    auto t = object->transform();
+
+    object->setParent(i > 0 ? objects[(i - 1) / fanout] : nullptr);
+    t->setLocalPosition({float(i % 13), 1, 0.5f});
+    t->setLocalEulerAngles({float(i % 7), float(i % 11), 1});
+    objects[i] = object;
+  }
+  scene->updateTransforms();
+
+  int maxThreads = std::max(16u, std::thread::hardware_concurrency());
+  std::vector<mat4f> reference;
+
+  printf("%d nodes, fanout %d, %u hardware threads\n",
+    n,
+    fanout,
+    std::thread::hardware_concurrency());
+  for (int threads = 1; threads <= maxThreads; threads *= 2)
+  {
+    scene->setThreadCount(threads);
+
+    double t = 0;
+
+    // Rotating the root makes every transform dirty
+    for (int frame = 0; frame < frameCount; ++frame)
+    {
+      objects[0]->transform()->setLocalEulerAngles({float(frame), 2, 3});
+
+      auto start = clock_type::now();
+
+      scene->updateTransforms();
+      t += std::chrono::duration<double, std::milli>{clock_type::now() -
+        start}.count();
+    }
+
+    // The matrices must be bitwise equal to the sequential ones
+    std::vector<mat4f> m(n);
+
+    for (int i = 0; i < n; ++i)
+      m[i] = objects[i]->transform()->localToWorldMatrix();
+    if (reference.empty())
+      reference = m;
+
+    auto same = !memcmp(reference.data(), m.data(), n * sizeof(mat4f));
+
+    printf("%2d threads: %7.2f ms/frame, %s\n",
+      threads,
+      t / frameCount,
+      same ? "identical" : "DIFFERENT");
+  }
+  return 0;
+}
@@ -0,0 +1,237 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: MeshOptimizerBench.cpp
+// ========
+// Vertex cache and overdraw report of MeshOptimizer.
+//
+// Author: Paulo Pagliosa
+// Last revision: 18/10/2026
+
+#include "geometry/MeshOptimizer.h"
+#include "utils/MeshReader.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace cg;
+using clock_type = std::chrono::steady_clock;
+
+namespace
+{ // begin namespace
+
+// Overdraw is measured by rasterizing the mesh in the triangle order,
+// with back face culling and an orthographic depth buffer, from the
+// directions of the faces and corners of a cube
+constexpr int resolution = 256;
+constexpr int numberOfViews = 14;
+
+inline double
+seconds(clock_type::time_point start)
+{
+  return std::chrono::duration<double>{clock_type::now() - start}.count();
+}
+
+inline float
+edge(float ax, float ay, float bx, float by, float px, float py)
+{
+  return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+}
+
+// Returns the number of fragments passing the depth test per covered
+// pixel from the view direction \c d
+float
+overdraw(const TriangleMesh::Data& data,
+  const Bounds3f& bounds,
+  const vec3f& d)
+{
+  // View basis and projection of the vertices onto the raster
+  const auto w = d.versor();
+  const auto u = (std::abs(w.x) < 0.9f ? vec3f{1, 0, 0} : vec3f{0, 1, 0})
+    .cross(w).versor();
+  const auto v = w.cross(u);
+  const auto c = bounds.center();
+  const auto s = resolution / bounds.diagonalLength();
+  const auto nv = data.numberOfVertices;
+  std::vector<vec3f> q(nv);
+
+  for (int i = 0; i < nv; ++i)
+  {
+    auto p = data.vertices[i] - c;
+    q[i].set(p.dot(u) * s + resolution / 2,
+      p.dot(v) * s + resolution / 2,
+      p.dot(w));
+  }
+
+  const auto far = math::Limits<float>::inf();
+  std::vector<float> depth(resolution * resolution, far);
+  int fragments = 0;
+
+  for (int i = 0; i < data.numberOfTriangles; ++i)
+  {
+    const auto& t = data.triangles[i];
+    const auto& a = q[t.v[0]];
+    const auto& b = q[t.v[1]];
+    const auto& e = q[t.v[2]];
+    auto area = edge(a.x, a.y, b.x, b.y, e.x, e.y);
+
+    // Back faces are clockwise in the raster
+    if (area <= 0)
+      continue;
+
+    auto x0 = std::max(0, int(std::min({a.x, b.x, e.x})));
+    auto x1 = std::min(resolution - 1, int(std::max({a.x, b.x, e.x})));
+    auto y0 = std::max(0, int(std::min({a.y, b.y, e.y})));
+    auto y1 = std::min(resolution - 1, int(std::max({a.y, b.y, e.y})));
+
+    for (int y = y0; y <= y1; ++y)
+      for (int x = x0; x <= x1; ++x)
+      {
+        auto px = x + 0.5f;
+        auto py = y + 0.5f;
+        auto w0 = edge(b.x, b.y, e.x, e.y, px, py) / area;
+        auto w1 = edge(e.x, e.y, a.x, a.y, px, py) / area;
+        auto w2 = 1 - w0 - w1;
+
+        if (w0 < 0 || w1 < 0 || w2 < 0)
+          continue;
+
+        auto z = -(w0 * a.z + w1 * b.z + w2 * e.z);
+        auto& zb = depth[y * resolution + x];
+
+        if (z < zb)
+        {
+          zb = z;
+          ++fragments;
+        }
+      }
+  }
+
+  auto covered = std::count_if(depth.begin(), depth.end(), [far](float z)
+  {
+    return z != far;
+  });
+  return covered ? float(fragments) / covered : 0;
+}
+
+void
+report(const char* label, const TriangleMesh::Data& data)
+{
+  static const vec3f views[numberOfViews]{
+    {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1},
+    {1, 1, 1}, {1, 1, -1}, {1, -1, 1}, {1, -1, -1},
+    {-1, 1, 1}, {-1, 1, -1}, {-1, -1, 1}, {-1, -1, -1}};
+  Bounds3f bounds;
+
+  for (int i = 0; i < data.numberOfVertices; ++i)
+    bounds.inflate(data.vertices[i]);
+
+  auto stats = MeshOptimizer::analyze(data);
+  float mean = 0;
+  float worst = 0;
+
+  for (const auto& d : views)
+  {
+    auto o = overdraw(data, bounds, d);
+
+    mean += o;
+    worst = std::max(worst, o);
+  }
+  printf("%-10s ACMR %.3f, ATVR %.3f, overdraw %.3f (max %.3f)\n",
+    label,
+    stats.acmr,
+    stats.atvr,
+    mean / numberOfViews,
+    worst);
+}
+
+} // end namespace
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    printf("Usage: %s file.obj [threshold]\n", argv[0]);
+    return 1;
+  }
+
+  Reference<TriangleMesh> mesh{MeshReader::readOBJ(argv[1], 0, false)};
+
+  if (mesh == nullptr)
+  {
+    printf("Unable to read %s\n", argv[1]);
+    return 1;
+  }
+
+  // The optimizer works on a copy of the mesh arrays
+  auto data = mesh->data();
+  std::vector<vec3f> vertices(data.vertices,
+    data.vertices + data.numberOfVertices);
+  std::vector<TriangleMesh::Triangle> triangles(data.triangles,
+    data.triangles + data.numberOfTriangles);
+
+  data.vertices = vertices.data();
+  data.vertexNormals = nullptr;
+  data.triangles = triangles.data();
+  printf("%d vertices, %d triangles, %d-entry FIFO cache\n",
+    data.numberOfVertices,
+    data.numberOfTriangles,
+    MeshOptimizer::cacheSize);
+  report("file order", data);
+
+  std::vector<int> clusters;
+  auto start = clock_type::now();
+
+  MeshOptimizer::optimizeVertexCache(data,
+    MeshOptimizer::cacheSize,
+    &clusters);
+
+  auto cacheTime = seconds(start);
+
+  report("tipsify", data);
+  start = clock_type::now();
+  MeshOptimizer::optimizeOverdraw(data,
+    clusters,
+    argc > 2 ? float(atof(argv[2])) : MeshOptimizer::overdrawThreshold);
+
+  auto overdrawTime = seconds(start);
+
+  report("overdraw", data);
+  start = clock_type::now();
+  MeshOptimizer::optimizeVertexFetch(data);
+
+  auto fetchTime = seconds(start);
+
+  printf("%d hard clusters; vertex cache %.3f s, overdraw %.3f s, "
+    "vertex fetch %.3f s\n",
+    int(clusters.size()),
+    cacheTime,
+    overdrawTime,
+    fetchTime);
+  return 0;
+}
@@ -0,0 +1,235 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: ObjReaderBench.cpp
+// ========
+// Wavefront OBJ reader benchmark.
+//
+// Author: Paulo Pagliosa
+// Last revision: 18/10/2026
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "utils/MeshReader.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+using namespace cg;
+using clock_type = std::chrono::steady_clock;
+
+namespace
+{ // begin namespace
+
+// Reference reader: the former MeshReader::readOBJ, which scans the
+// file twice with fscanf, first to count the vertices and triangles
+// and then to read them. It does not accept negative indices
+void
+scanOBJ(FILE* file, TriangleMesh::Data& data, bool count)
+{
+  const unsigned int lineSize{128};
+  auto vertex = data.vertices;
+  auto triangle = data.triangles;
+  int nv{};
+  int nt{};
+
+  for (char line[lineSize]; fscanf(file, "%127s", line) != EOF;)
+    switch (line[0])
+    {
+      case 'v':
+        if (line[1] != '\0')
+          fgets(line, lineSize, file);
+        else if (count)
+        {
+          nv++;
+          fgets(line, lineSize, file);
+        }
+        else
+        {
+          float x, y, z;
+
+          fscanf(file, "%f %f %f", &x, &y, &z);
+          (vertex++)->set(x, y, z);
+        }
+        break;
+
+      case 'f':
+      {
+        int v, t, n;
+
+        fscanf(file, "%127s", line);
+
+        // Can be one of %d, %d//%d, %d/%d, %d/%d/%d
+        const char* format = "%d";
+
+        if (strstr(line, "//"))
+          format = "%d//%d";
+        else if (sscanf(line, "%d/%d/%d", &v, &t, &n) == 3)
+          format = "%d/%d/%d";
+        else if (sscanf(line, "%d/%d", &v, &t) == 2)
+          format = "%d/%d";
+
+        int v0, v1;
+
+        sscanf(line, format, &v0, &t, &n);
+        fscanf(file, format, &v1, &t, &n);
+        while (fscanf(file, format, &v, &t, &n) > 0)
+        {
+          if (!count)
+            (triangle++)->setVertices(v0 - 1, v1 - 1, v - 1);
+          v1 = v;
+          nt++;
+        }
+        break;
+      }
+
+      default:
+        fgets(line, lineSize, file);
+    }
+  if (count)
+  {
+    data.numberOfVertices = nv;
+    data.numberOfTriangles = nt;
+  }
+}
+
+TriangleMesh*
+readReference(const char* filename)
+{
+  auto file = fopen(filename, "r");
+
+  if (file == nullptr)
+    return nullptr;
+
+  TriangleMesh::Data data;
+
+  scanOBJ(file, data, true);
+  data.vertices = new vec3f[data.numberOfVertices];
+  data.vertexNormals = nullptr;
+  data.triangles = new TriangleMesh::Triangle[data.numberOfTriangles];
+  rewind(file);
+  scanOBJ(file, data, false);
+  fclose(file);
+
+  auto mesh = new TriangleMesh{data};
+
+  mesh->computeNormals();
+  return mesh;
+}
+
+long long
+fileSize(const char* filename)
+{
+  auto file = fopen(filename, "rb");
+
+  if (file == nullptr)
+    return 0;
+  fseek(file, 0, SEEK_END);
+
+  long long size = ftell(file);
+
+  fclose(file);
+  return size;
+}
+
+bool
+equal(const TriangleMesh& a, const TriangleMesh& b)
+{
+  const auto& p = a.data();
+  const auto& q = b.data();
+
+  return p.numberOfVertices == q.numberOfVertices &&
+    p.numberOfTriangles == q.numberOfTriangles &&
+    !memcmp(p.vertices, q.vertices, p.numberOfVertices * sizeof(vec3f)) &&
+    !memcmp(p.triangles,
+      q.triangles,
+      p.numberOfTriangles * sizeof(TriangleMesh::Triangle));
+}
+
+template <typename Read>
+Reference<TriangleMesh>
+run(const char* label, double mb, Read read)
+{
+  auto start = clock_type::now();
+  Reference<TriangleMesh> mesh{read()};
+  std::chrono::duration<double> t{clock_type::now() - start};
+
+  printf("%-16s %8.3f s %8.1f MB/s\n",
+    label,
+    t.count(),
+    t.count() > 0 ? mb / t.count() : 0.0);
+  return mesh;
+}
+
+} // end namespace
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    printf("Usage: %s file.obj [-noref]\n", argv[0]);
+    return 1;
+  }
+
+  const auto filename = argv[1];
+  const auto mb = fileSize(filename) / (1024.0 * 1024.0);
+  auto reference = argc > 2 && !strcmp(argv[2], "-noref") ?
+    nullptr :
+    run("fscanf (2 pass)", mb, [filename]
+    {
+      return readReference(filename);
+    });
+  // The meshes are read without reordering, as the reference reader
+  auto mesh = run("mapped, 1 thread", mb, [filename]
+  {
+    return MeshReader::readOBJ(filename, 1, false);
+  });
+
+  for (int n = 2, m = std::thread::hardware_concurrency(); n <= m; n *= 2)
+  {
+    char label[32];
+
+    snprintf(label, sizeof label, "mapped, %d threads", n);
+    run(label, mb, [filename, n]
+    {
+      return MeshReader::readOBJ(filename, n, false);
+    });
+  }
+  if (mesh == nullptr)
+  {
+    printf("Unable to read %s\n", filename);
+    return 1;
+  }
+  printf("%d vertices, %d triangles, %.1f MB\n",
+    mesh->data().numberOfVertices,
+    mesh->data().numberOfTriangles,
+    mb);
+  if (reference != nullptr)
+    printf("Same mesh as the reference: %s\n",
+      equal(*reference, *mesh) ? "yes" : "no");
+  return 0;
+}
@@ -0,0 +1,261 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: RayPacketBench.cpp
+// ========
+// Ray packet kernel microbenchmark.
+//
+// Author: Paulo Pagliosa
+// Last revision: 18/10/2026
+
+#include "geometry/RayPacket.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace cg;
+using clock_type = std::chrono::steady_clock;
+
+namespace
+{ // begin namespace
+
+// Rays from a 32x32 grid to boxes and triangles scattered in [-1,1]^3
+constexpr int raySide = 32;
+constexpr int numberOfPrimitives = 512;
+
+volatile int sink;
+
+inline double
+nanoseconds(clock_type::time_point start, double tests)
+{
+  std::chrono::duration<double, std::nano> t{clock_type::now() - start};
+  return t.count() / tests;
+}
+
+// Scalar Moller-Trumbore, as in BVH::intersectTriangle
+bool
+intersectTriangle(const Ray& ray,
+  const vec3f& v0,
+  const vec3f& v1,
+  const vec3f& v2)
+{
+  const auto e1 = v1 - v0;
+  const auto e2 = v2 - v0;
+  const auto p = ray.direction.cross(e2);
+  const auto d = e1.dot(p);
+
+  if (math::isZero(d))
+    return false;
+
+  const auto invD = math::inverse(d);
+  const auto s = ray.origin - v0;
+  const auto b1 = s.dot(p) * invD;
+
+  if (b1 < 0 || b1 > 1)
+    return false;
+
+  const auto q = s.cross(e1);
+  const auto b2 = ray.direction.dot(q) * invD;
+
+  if (b2 < 0 || b1 + b2 > 1)
+    return false;
+
+  const auto t = e2.dot(q) * invD;
+  return t >= ray.tMin && t <= ray.tMax;
+}
+
+inline bool
+intersectBox(const Bounds3f& box, const Ray& ray)
+{
+  float tMin, tMax;
+
+  return box.intersect(ray, tMin, tMax) &&
+    tMax >= ray.tMin && tMin <= ray.tMax;
+}
+
+struct Input
+{
+  std::vector<Ray> rays;
+  std::vector<Bounds3f> boxes;
+  std::vector<vec3f> vertices; // three per triangle
+
+  Input();
+
+}; // Input
+
+Input::Input()
+{
+  std::mt19937 g{1};
+  std::uniform_real_distribution<float> u{-1, 1};
+
+  for (int y = 0; y < raySide; ++y)
+    for (int x = 0; x < raySide; ++x)
+    {
+      vec3f d{x * 2.0f / raySide - 1, y * 2.0f / raySide - 1, -2};
+      rays.push_back(Ray{vec3f{0, 0, 5}, d});
+    }
+  for (int i = 0; i < numberOfPrimitives; ++i)
+  {
+    vec3f c{u(g), u(g), u(g)};
+    boxes.push_back(Bounds3f{c - vec3f{0.1f}, c + vec3f{0.1f}});
+  }
+  for (int i = 0; i < numberOfPrimitives; ++i)
+  {
+    vec3f c{u(g), u(g), u(g)};
+
+    for (int k = 0; k < 3; ++k)
+      vertices.push_back(c + vec3f{u(g), u(g), u(g)} * 0.3f);
+  }
+}
+
+void
+runScalar(const Input& in)
+{
+  const auto tests = double(in.rays.size()) * numberOfPrimitives;
+  const auto& v = in.vertices;
+  int hits = 0;
+  auto start = clock_type::now();
+
+  for (const auto& b : in.boxes)
+    for (const auto& r : in.rays)
+      hits += intersectBox(b, r);
+
+  auto box = nanoseconds(start, tests);
+
+  start = clock_type::now();
+  for (int i = 0; i < numberOfPrimitives; ++i)
+    for (const auto& r : in.rays)
+      hits += intersectTriangle(r, v[3 * i], v[3 * i + 1], v[3 * i + 2]);
+
+  auto triangle = nanoseconds(start, tests);
+
+  sink = hits;
+  printf("scalar: ray-box %.2f ns, ray-triangle %.2f ns\n", box, triangle);
+}
+
+template <int N>
+void
+runPacket(const Input& in)
+{
+  const int numberOfRays = int(in.rays.size());
+  const auto tests = double(numberOfRays) * numberOfPrimitives;
+  const auto& v = in.vertices;
+  std::vector<RayPacket<N>> rays(numberOfRays / N);
+  std::vector<BoundsPacket<N>> boxes(numberOfPrimitives / N);
+  std::vector<TrianglePacket<N>> triangles(numberOfPrimitives / N);
+
+  for (int i = 0; i < numberOfRays; ++i)
+    rays[i / N].set(i % N, in.rays[i]);
+  for (int i = 0; i < numberOfPrimitives; ++i)
+  {
+    boxes[i / N].set(i % N, in.boxes[i]);
+    triangles[i / N].set(i % N, v[3 * i], v[3 * i + 1], v[3 * i + 2]);
+  }
+
+  float t[N], b1[N], b2[N];
+  int hits = 0;
+  auto start = clock_type::now();
+
+  for (const auto& b : in.boxes)
+    for (const auto& p : rays)
+      hits += intersect(b, p, t);
+
+  auto raysBox = nanoseconds(start, tests);
+
+  start = clock_type::now();
+  for (const auto& r : in.rays)
+  {
+    const vec3f invDir{math::inverse(r.direction.x),
+      math::inverse(r.direction.y),
+      math::inverse(r.direction.z)};
+
+    for (const auto& p : boxes)
+      hits += intersect(p, r, invDir, r.tMax, t);
+  }
+
+  auto rayBoxes = nanoseconds(start, tests);
+
+  start = clock_type::now();
+  for (int i = 0; i < numberOfPrimitives; ++i)
+    for (const auto& p : rays)
+      hits += intersect(v[3 * i], v[3 * i + 1], v[3 * i + 2], p, t, b1, b2);
+
+  auto raysTriangle = nanoseconds(start, tests);
+
+  start = clock_type::now();
+  for (const auto& r : in.rays)
+    for (const auto& p : triangles)
+      hits += intersect(p, r, r.tMax, t, b1, b2);
+
+  auto rayTriangles = nanoseconds(start, tests);
+
+  sink = hits;
+
+  // Check the hit masks against the scalar tests
+  int mismatches = 0;
+
+  for (int k = 0; k < numberOfPrimitives; ++k)
+    for (int i = 0; i < numberOfRays; ++i)
+    {
+      const auto& r = in.rays[i];
+      const auto& p = rays[i / N];
+      const auto lane = i % N;
+      auto box = intersect(in.boxes[k], p, t) >> lane & 1;
+      auto triangle = intersect(v[3 * k], v[3 * k + 1], v[3 * k + 2],
+        p,
+        t,
+        b1,
+        b2) >> lane & 1;
+
+      mismatches += box != int(intersectBox(in.boxes[k], r));
+      mismatches += triangle !=
+        int(intersectTriangle(r, v[3 * k], v[3 * k + 1], v[3 * k + 2]));
+    }
+  printf("N=%d: rays-box %.2f ns, ray-boxes %.2f ns, "
+    "rays-triangle %.2f ns, ray-triangles %.2f ns, mismatches %d\n",
+    N,
+    raysBox,
+    rayBoxes,
+    raysTriangle,
+    rayTriangles,
+    mismatches);
+}
+
+} // end namespace
+
+int
+main()
+{
+  Input in;
+
+  printf("%d rays x %d primitives, time per ray-primitive test\n",
+    raySide * raySide,
+    numberOfPrimitives);
+  runScalar(in);
+  runPacket<4>(in);
+  runPacket<8>(in);
+  return 0;
+}
@@ -0,0 +1,169 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2014, 2019 Orthrus Group.                         |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: SceneBVHTest.cpp
+// ========
+// Scene BVH tests.
+//
+// Author(s): Paulo Pagliosa, Carlos Monteiro e Yago Mescolotte
+// Last revision: 18/10/2026
+
+#include "Scene.h"
+#include <cstdio>
+
+using namespace cg;
+
+namespace
+{ // begin namespace
+
+int failures;
+
+void
+check(bool condition, const char* what)
+{
+  printf("%s: %s\n", condition ? "ok" : "FAILED", what);
+  if (!condition)
+    ++failures;
+}
+
+// Grid of 2n^2 triangles in the square [-1,1]^2 of the plane z = 0
+TriangleMesh*
+makeGrid(int n)
+{
+  TriangleMesh::Data data;
+
+  data.numberOfVertices = (n + 1) * (n + 1);
+  data.vertices = new vec3f[data.numberOfVertices];
+  data.vertexNormals = nullptr;
+  data.numberOfTriangles = 2 * n * n;
+  data.triangles = new TriangleMesh::Triangle[data.numberOfTriangles];
+
+  auto v = data.vertices;
+
+  for (int i = 0; i <= n; ++i)
+    for (int j = 0; j <= n; ++j)
+      (v++)->set(2.0f * j / n - 1, 2.0f * i / n - 1, 0);
+
+  auto t = data.triangles;
+
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+    {
+      auto a = i * (n + 1) + j;
+      auto c = a + n + 1;
+
+      (t++)->setVertices(a, a + 1, c);
+      (t++)->setVertices(a + 1, c + 1, c);
+    }
+  return new TriangleMesh{data};
+}
+
+SceneObject*
+makeObject(Scene& scene, SceneObject* parent, TriangleMesh* mesh, float x)
+{
+  auto object = new SceneObject{"object", scene};
+
+  object->setParent(parent);
+  object->transform()->setLocalPosition({x, 0, 0});
+  if (mesh != nullptr)
+    object->addComponent(new Primitive{mesh, "grid"});
+  return object;
+}
+
+// Returns true if a ray down the z axis at x hits a primitive
+bool
+hitsAt(const SceneBVH& bvh, float x)
+{
+  return bvh.intersect(Ray{vec3f{x, 0, 5}, vec3f{0, 0, -1}});
+}
+
+void
+testDeletedObjects()
+{
+  Reference<Scene> scene{new Scene{"scene"}};
+  Reference<TriangleMesh> mesh{makeGrid(1)};
+  auto root = scene->root();
+  auto& bvh = scene->bvh();
+
+  makeObject(*scene, root, mesh, -4);
+
+  auto deleted = makeObject(*scene, root, mesh, 0);
+  // Parent with no primitive of an object with one
+  auto parent = makeObject(*scene, root, nullptr, 4);
+
+  makeObject(*scene, parent, mesh, 0);
+  // Object created but never added to the hierarchy
+  Reference<SceneObject> orphan{new SceneObject{"orphan", *scene}};
+
+  orphan->addComponent(new Primitive{mesh, "grid"});
+  orphan->transform()->setLocalPosition({8, 0, 0});
+  bvh.update();
+  check(bvh.size() == 3, "objects in the hierarchy are in the BVH");
+  check(!hitsAt(bvh, 8), "objects not in the hierarchy are not hit");
+
+  // As P2::deleteObject()
+  root->removeSceneObject(deleted);
+  root->removeSceneObject(parent);
+  bvh.update();
+  bvh.update();
+  check(bvh.size() == 1, "deleted objects leave the BVH");
+  check(hitsAt(bvh, -4), "remaining object is hit");
+  check(!hitsAt(bvh, 0) && !hitsAt(bvh, 4), "deleted objects are not hit");
+
+  // Objects entering the hierarchy again are back in the BVH
+  orphan->setParent(root);
+  bvh.update();
+  check(bvh.size() == 2 && hitsAt(bvh, 8), "added objects enter the BVH");
+}
+
+void
+testLargeMeshes()
+{
+  Reference<Scene> scene{new Scene{"scene"}};
+  // 20000 triangles, more than the BVH builds without background tasks
+  Reference<TriangleMesh> mesh{makeGrid(100)};
+  auto& bvh = scene->bvh();
+
+  makeObject(*scene, scene->root(), mesh, 0);
+  // As in the editor, whose frames do not wait for the build
+  bvh.update();
+  check(bvh.size() == 0 && bvh.isBuilding(mesh),
+    "large meshes are left out while their BVH is built");
+  bvh.update(true);
+  check(bvh.size() == 1 && hitsAt(bvh, 0),
+    "large meshes are in the BVH after a blocking update");
+  check(!bvh.isBuilding(mesh), "no mesh BVH is left being built");
+}
+
+} // end namespace
+
+int
+main()
+{
+  testDeletedObjects();
+  testLargeMeshes();
+  printf("%d failure(s)\n", failures);
+  return failures != 0;
+}